@@ -0,0 +1,82 @@
+// Include standard headers
+#include "Definitions.h"
+#include "MyBenchmark.h"
+
+//Scenes bigger than this skip the brute force run, it checks every pair each frame
+static const Simplex::uint BRUTE_FORCE_LIMIT = 2500;
+
+/*
+USAGE: A05 - Benchmark [scene] [entities] [frames] [seed] [margin]
+ARGUMENTS:
+- scene -> uniform, shell, clustered, mixed, flat or all (all by default)
+- entities -> number of entities in each scene (1849 by default, as A05 in release)
+- frames -> frames each broad phase runs for (300 by default)
+- seed -> seed of the scenes and of the motion (1 by default)
+- margin -> distance the proxy boxes reach past the global boxes (0 by default)
+OUTPUT: 0 if the benchmark ran, 1 otherwise
+*/
+int main(int argc, char* argv[])
+{
+	using namespace Simplex;
+	String sScene = argc > 1 ? argv[1] : "all";
+	uint uEntityCount = argc > 2 ? atoi(argv[2]) : 1849;
+	uint uFrameCount = argc > 3 ? atoi(argv[3]) : 300;
+	uint uSeed = argc > 4 ? atoi(argv[4]) : 1;
+	float fMargin = argc > 5 ? (float)atof(argv[5]) : 0.0f;
+
+	std::vector<uint> lScene;
+	for (uint i = 0; i < BENCHMARK_SCENE_COUNT; i++)
+	{
+		if (sScene == "all" || sScene == MyBenchmark::GetSceneName(i))
+			lScene.push_back(i);
+	}
+	if (lScene.empty())
+	{
+		fprintf(stderr, "Unknown scene %s, use uniform, shell, clustered, mixed, flat or all\n", sScene.c_str());
+		return 1;
+	}
+
+	//Loading a model uploads its meshes, so an offscreen context stands in for the window
+	sf::Context context(sf::ContextSettings(24, 0, 0, 4, 5, 0, false), 1, 1);
+	glewExperimental = true; // Needed for core profile
+	if (glewInit() != GLEW_OK) {
+		fprintf(stderr, "Failed to initialize GLEW\n");
+		return 1;
+	}
+	SystemSingleton::GetInstance();
+	MeshManager::GetInstance();
+
+	for (uint i = 0; i < lScene.size(); i++)
+	{
+		MyBenchmark benchmark(lScene[i], uEntityCount, uFrameCount, uSeed);
+		benchmark.SetProxyMargin(fMargin);
+		printf("Scene: %s Entities: %d Frames: %d Seed: %d Margin: %.2f\n",
+			MyBenchmark::GetSceneName(lScene[i]).c_str(), uEntityCount, uFrameCount, uSeed, fMargin);
+		printf("%-16s %9s %9s %9s %9s %9s %11s %10s %10s\n",
+			"Broad phase", "Build", "Update", "Pairs", "Collide", "Worst", "Candidates", "Colliding", "Memory");
+		printf("%-16s %9s %9s %9s %9s %9s %11s %10s %10s\n",
+			"", "[ms]", "[ms]", "[ms]", "[ms]", "[ms]", "", "", "[KB]");
+		for (uint j = 0; j < BENCHMARK_BROAD_PHASE_COUNT; j++)
+		{
+			if (j == BENCHMARK_BRUTE_FORCE && uEntityCount > BRUTE_FORCE_LIMIT)
+			{
+				printf("%-16s skipped, more than %d entities\n", MyBenchmark::GetBroadPhaseName(j).c_str(), BRUTE_FORCE_LIMIT);
+				continue;
+			}
+			MyBenchmarkResult result = benchmark.Run(j);
+			printf("%-16s %9.3f %9.3f %9.3f %9.3f %9.3f %11.1f %10.1f %10.1f\n",
+				MyBenchmark::GetBroadPhaseName(j).c_str(), result.m_fBuildTime, result.m_fUpdateTime, result.m_fPairTime,
+				result.m_fCollisionTime, result.m_fWorstFrameTime, result.m_fCandidatePairCount,
+				result.m_fCollidingPairCount, result.m_uMemory / 1024.0f);
+		}
+		printf("\n");
+		//Each scene starts from an empty entity manager
+		MyEntityManager::ReleaseInstance();
+	}
+
+	MyWorkerPool::ReleaseInstance();
+
+	// Release the Simplex singletons
+	Simplex::ReleaseAllSingletons();
+	return 0;
+}
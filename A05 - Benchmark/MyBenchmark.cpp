@@ -0,0 +1,278 @@
+#include "MyBenchmark.h"
+using namespace Simplex;
+
+//Constructor for the benchmark
+MyBenchmark::MyBenchmark(uint a_uScene, uint a_uEntityCount, uint a_uFrameCount, uint a_uSeed)
+{
+	Init();
+	m_uScene = a_uScene;
+	m_uFrameCount = a_uFrameCount;
+	m_uSeed = a_uSeed;
+	BuildScene(a_uEntityCount);
+}
+
+//Copy constructor for the benchmark
+MyBenchmark::MyBenchmark(MyBenchmark const& other)
+{
+	m_uScene = other.m_uScene;
+	m_uFrameCount = other.m_uFrameCount;
+	m_uSeed = other.m_uSeed;
+	m_uMovePercent = other.m_uMovePercent;
+	m_uOctantLevels = other.m_uOctantLevels;
+	m_fProxyMargin = other.m_fProxyMargin;
+	m_lStart = other.m_lStart;
+	m_lPosition = other.m_lPosition;
+	m_lScale = other.m_lScale;
+	m_pEntityMngr = MyEntityManager::GetInstance();
+}
+
+//Copy assignment operator for the benchmark
+MyBenchmark& MyBenchmark::operator=(MyBenchmark const& other)
+{
+	if(this != &other)
+	{
+		Release();
+		Init();
+		MyBenchmark benchmark(other);
+		Swap(benchmark);
+	}
+	return *this;
+}
+
+//Destructor for the benchmark
+MyBenchmark::~MyBenchmark()
+{
+	Release();
+}
+
+//Swaps the values of the benchmark with the values of the one passed in
+void MyBenchmark::Swap(MyBenchmark& other)
+{
+	std::swap(m_uScene, other.m_uScene);
+	std::swap(m_uFrameCount, other.m_uFrameCount);
+	std::swap(m_uSeed, other.m_uSeed);
+	std::swap(m_uMovePercent, other.m_uMovePercent);
+	std::swap(m_uOctantLevels, other.m_uOctantLevels);
+	std::swap(m_fProxyMargin, other.m_fProxyMargin);
+	std::swap(m_lStart, other.m_lStart);
+	std::swap(m_lPosition, other.m_lPosition);
+	std::swap(m_lScale, other.m_lScale);
+	m_pEntityMngr = MyEntityManager::GetInstance();
+}
+
+//Runs a broad phase over the frames of the benchmark
+MyBenchmarkResult MyBenchmark::Run(uint a_uBroadPhase)
+{
+	MyBenchmarkResult result;
+	uint entityCount = m_lStart.size();
+	m_lPosition = m_lStart;
+	for(uint i = 0; i < entityCount; i++)
+	{
+		PlaceEntity(i);
+	}
+	//The proxy boxes are refit so the last run does not leave them behind
+	m_pEntityMngr->SetProxyMargin(m_fProxyMargin);
+	//Every broad phase sees the same motion
+	srand(m_uSeed + 1);
+
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	MyBroadPhase* broadPhase = nullptr;
+	switch(a_uBroadPhase)
+	{
+	case BENCHMARK_OCTREE:
+		broadPhase = new MyOctant(m_uOctantLevels, 5, OCTANT_SPARSE | OCTANT_ADAPTIVE);
+		break;
+	case BENCHMARK_QUADTREE:
+		broadPhase = new MyQuadtree(m_uOctantLevels, 5, OCTANT_SPARSE | OCTANT_ADAPTIVE);
+		break;
+	case BENCHMARK_DYNAMIC_TREE:
+		broadPhase = new MyDynamicTree();
+		break;
+	case BENCHMARK_SWEEP_AND_PRUNE:
+		broadPhase = new MySweepAndPrune();
+		break;
+	case BENCHMARK_HASH_GRID:
+		broadPhase = new MyHashGrid();
+		break;
+	}
+	std::chrono::duration<float, std::milli> buildTime = std::chrono::high_resolution_clock::now() - start;
+	result.m_fBuildTime = buildTime.count();
+
+	for(uint i = 0; i < m_uFrameCount; i++)
+	{
+		MoveEntities();
+		m_pEntityMngr->Update(broadPhase);
+		float updateTime = m_pEntityMngr->GetUpdateTime();
+		float pairTime = m_pEntityMngr->GetPairTime();
+		float collisionTime = m_pEntityMngr->GetCollisionTime();
+		result.m_fUpdateTime += updateTime;
+		result.m_fPairTime += pairTime;
+		result.m_fCollisionTime += collisionTime;
+		result.m_fWorstFrameTime = std::max(result.m_fWorstFrameTime, updateTime + pairTime + collisionTime);
+		result.m_fCandidatePairCount += m_pEntityMngr->GetCandidatePairCount();
+		result.m_fCollidingPairCount += m_pEntityMngr->GetCollidingPairCount();
+	}
+	if(m_uFrameCount > 0)
+	{
+		result.m_fUpdateTime /= m_uFrameCount;
+		result.m_fPairTime /= m_uFrameCount;
+		result.m_fCollisionTime /= m_uFrameCount;
+		result.m_fCandidatePairCount /= m_uFrameCount;
+		result.m_fCollidingPairCount /= m_uFrameCount;
+	}
+	if(broadPhase != nullptr)
+	{
+		result.m_uMemory = broadPhase->GetMemoryUsage();
+		SafeDelete(broadPhase);
+	}
+	//The octree leaves its leafs in the dimensions of the entities
+	m_pEntityMngr->ClearDimensionSetAll();
+	return result;
+}
+
+//Sets the move percent
+void MyBenchmark::SetMovePercent(uint a_uMovePercent)
+{
+	m_uMovePercent = a_uMovePercent;
+}
+
+//Sets the octree levels
+void MyBenchmark::SetOctantLevels(uint a_uOctantLevels)
+{
+	m_uOctantLevels = a_uOctantLevels;
+}
+
+//Sets the proxy margin
+void MyBenchmark::SetProxyMargin(float a_fProxyMargin)
+{
+	m_fProxyMargin = a_fProxyMargin;
+}
+
+//Gets the name of a scene
+String MyBenchmark::GetSceneName(uint a_uScene)
+{
+	switch(a_uScene)
+	{
+	case BENCHMARK_UNIFORM:
+		return "uniform";
+	case BENCHMARK_SHELL:
+		return "shell";
+	case BENCHMARK_CLUSTERED:
+		return "clustered";
+	case BENCHMARK_MIXED:
+		return "mixed";
+	case BENCHMARK_FLAT:
+		return "flat";
+	}
+	return "";
+}
+
+//Gets the name of a broad phase
+String MyBenchmark::GetBroadPhaseName(uint a_uBroadPhase)
+{
+	switch(a_uBroadPhase)
+	{
+	case BENCHMARK_BRUTE_FORCE:
+		return "brute force";
+	case BENCHMARK_OCTREE:
+		return "octree";
+	case BENCHMARK_QUADTREE:
+		return "quadtree";
+	case BENCHMARK_DYNAMIC_TREE:
+		return "AABB tree";
+	case BENCHMARK_SWEEP_AND_PRUNE:
+		return "sweep and prune";
+	case BENCHMARK_HASH_GRID:
+		return "hash grid";
+	}
+	return "";
+}
+
+//Release the benchmark (used in the destructor)
+void MyBenchmark::Release()
+{
+	m_lStart.clear();
+	m_lPosition.clear();
+	m_lScale.clear();
+}
+
+//Initialize the benchmark without entities
+void MyBenchmark::Init()
+{
+	m_pEntityMngr = MyEntityManager::GetInstance();
+	m_uScene = BENCHMARK_SHELL;
+	m_uFrameCount = 0;
+	m_uSeed = 0;
+	m_uMovePercent = 10;
+	m_uOctantLevels = 3;
+	m_fProxyMargin = 0.0f;
+}
+
+//Builds the scene
+void MyBenchmark::BuildScene(uint a_uEntityCount)
+{
+	srand(m_uSeed);
+	vector3 cluster[CLUSTER_COUNT];
+	for(uint i = 0; i < CLUSTER_COUNT; i++)
+	{
+		cluster[i] = glm::linearRand(vector3(-34.0f), vector3(34.0f));
+	}
+	m_lStart.resize(a_uEntityCount);
+	m_lScale.resize(a_uEntityCount);
+	for(uint i = 0; i < a_uEntityCount; i++)
+	{
+		m_lScale[i] = 1.0f;
+		switch(m_uScene)
+		{
+		case BENCHMARK_UNIFORM:
+			m_lStart[i] = glm::linearRand(vector3(-34.0f), vector3(34.0f));
+			break;
+		case BENCHMARK_SHELL:
+			m_lStart[i] = glm::sphericalRand(34.0f);
+			break;
+		case BENCHMARK_CLUSTERED:
+			m_lStart[i] = cluster[rand() % CLUSTER_COUNT] + glm::gaussRand(vector3(0.0f), vector3(4.0f));
+			break;
+		case BENCHMARK_MIXED:
+			m_lStart[i] = glm::linearRand(vector3(-34.0f), vector3(34.0f));
+			//Most entities stay unit sized, the rest reach from a few units to a tenth of the box
+			if(rand() % 4 == 0)
+			{
+				m_lScale[i] = glm::linearRand(2.0f, 8.0f);
+			}
+			break;
+		case BENCHMARK_FLAT:
+			m_lStart[i] = vector3(glm::linearRand(-34.0f, 34.0f), 0.0f, glm::linearRand(-34.0f, 34.0f));
+			break;
+		}
+	}
+	m_lPosition = m_lStart;
+	//The entities are added in one call so big scenes do not grow the entity list one at a time
+	std::vector<matrix4> lToWorld(a_uEntityCount);
+	for(uint i = 0; i < a_uEntityCount; i++)
+	{
+		lToWorld[i] = glm::translate(m_lPosition[i]) * glm::scale(vector3(m_lScale[i]));
+	}
+	m_pEntityMngr->AddEntities("Minecraft\\Cube.obj", lToWorld);
+}
+
+//Moves some of the entities
+void MyBenchmark::MoveEntities()
+{
+	uint entityCount = m_lPosition.size();
+	for(uint i = 0; i < entityCount; i++)
+	{
+		if((uint)(rand() % 100) >= m_uMovePercent)
+		{
+			continue;
+		}
+		m_lPosition[i] += glm::ballRand(0.5f);
+		PlaceEntity(i);
+	}
+}
+
+//Places an entity
+void MyBenchmark::PlaceEntity(uint a_uIndex)
+{
+	m_pEntityMngr->SetModelMatrix(glm::translate(m_lPosition[a_uIndex]) * glm::scale(vector3(m_lScale[a_uIndex])), a_uIndex);
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "MyOctant.h"
+#include "MyDynamicTree.h"
+#include "MySweepAndPrune.h"
+#include "MyHashGrid.h"
+#include "MyWorkerPool.h"
+
+namespace Simplex
+{
+	//Ways of spreading the entities of a benchmark scene
+	enum eBenchmarkScene
+	{
+		BENCHMARK_UNIFORM = 0, //unit cubes anywhere in a box as wide as the A05 sphere
+		BENCHMARK_SHELL = 1, //unit cubes on a sphere of radius 34, as A05 places them
+		BENCHMARK_CLUSTERED = 2, //unit cubes packed around a few points of the box
+		BENCHMARK_MIXED = 3, //cubes of very different sizes anywhere in the box
+		BENCHMARK_FLAT = 4, //unit cubes spread over the y = 0 plane, as A03 lays out its grid of cones
+		BENCHMARK_SCENE_COUNT = 5,
+	};
+
+	//Broad phases a benchmark can run
+	enum eBenchmarkBroadPhase
+	{
+		BENCHMARK_BRUTE_FORCE = 0, //every pair is checked
+		BENCHMARK_OCTREE = 1, //MyOctant
+		BENCHMARK_QUADTREE = 2, //MyQuadtree
+		BENCHMARK_DYNAMIC_TREE = 3, //MyDynamicTree
+		BENCHMARK_SWEEP_AND_PRUNE = 4, //MySweepAndPrune
+		BENCHMARK_HASH_GRID = 5, //MyHashGrid
+		BENCHMARK_BROAD_PHASE_COUNT = 6,
+	};
+
+	//Measurements of a broad phase over the frames of a benchmark, times and pair counts are averages per frame
+	struct MyBenchmarkResult
+	{
+		float m_fBuildTime = 0.0f; //milliseconds the broad phase took to be built
+		float m_fUpdateTime = 0.0f; //milliseconds the broad phase took to catch up with the entities
+		float m_fPairTime = 0.0f; //milliseconds the broad phase took to list the candidate pairs
+		float m_fCollisionTime = 0.0f; //milliseconds the collision checks took
+		float m_fWorstFrameTime = 0.0f; //milliseconds the slowest frame took
+		float m_fCandidatePairCount = 0.0f; //pairs checked for collision
+		float m_fCollidingPairCount = 0.0f; //pairs found colliding
+		size_t m_uMemory = 0; //bytes the broad phase held after the last frame
+	};
+
+	//Fills the entity manager with a seeded scene and runs MyEntityManager::Update with each broad phase
+	//over the same frames, no window or rendering is involved
+	class MyBenchmark
+	{
+	public:
+		static const uint CLUSTER_COUNT = 8; //points the entities of a clustered scene gather around
+
+	private:
+		MyEntityManager* m_pEntityMngr = nullptr; //entity manager singleton
+
+		uint m_uScene = BENCHMARK_SHELL; //eBenchmarkScene of the entities
+		uint m_uFrameCount = 0; //frames each broad phase runs for
+		uint m_uSeed = 0; //seed of the scene and of the motion
+		uint m_uMovePercent = 10; //chance out of 100 that an entity moves in a frame
+		uint m_uOctantLevels = 3; //maximum level of the octree and of the quadtree
+		float m_fProxyMargin = 0.0f; //distance the proxy boxes of the entities reach past their global boxes
+
+		std::vector<vector3> m_lStart; //starting position of each entity
+		std::vector<vector3> m_lPosition; //position of each entity in the frame being run
+		std::vector<float> m_lScale; //size of each entity
+
+	public:
+		/*
+		USAGE: Constructor, adds the entities of the scene to the entity manager, which should be empty
+		ARGUMENTS:
+		- uint a_uScene -> eBenchmarkScene to build
+		- uint a_uEntityCount -> number of entities in the scene
+		- uint a_uFrameCount -> number of frames each broad phase runs for
+		- uint a_uSeed -> seed of the scene and of the motion, the same seed gives the same frames
+		OUTPUT: class object
+		*/
+		MyBenchmark(uint a_uScene, uint a_uEntityCount, uint a_uFrameCount, uint a_uSeed);
+		/*
+		USAGE: Copy constructor
+		ARGUMENTS: class object to copy
+		OUTPUT: class object instance
+		*/
+		MyBenchmark(MyBenchmark const& other);
+		/*
+		USAGE: Copy assignment operator
+		ARGUMENTS: class object to copy
+		OUTPUT: ---
+		*/
+		MyBenchmark& operator=(MyBenchmark const& other);
+		/*
+		USAGE: Destructor, the entities of the scene stay in the entity manager
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		~MyBenchmark();
+		/*
+		USAGE: Changes object contents for other object's
+		ARGUMENTS:
+		- MyBenchmark& other -> object to swap content from
+		OUTPUT: ---
+		*/
+		void Swap(MyBenchmark& other);
+		/*
+		USAGE: Puts the entities back at the start of the scene, builds a broad phase and updates the
+		entity manager with it for every frame, moving some entities between frames
+		ARGUMENTS:
+		- uint a_uBroadPhase -> eBenchmarkBroadPhase to run
+		OUTPUT: measurements of the run
+		*/
+		MyBenchmarkResult Run(uint a_uBroadPhase);
+		/*
+		USAGE: Sets the chance that an entity moves in a frame
+		ARGUMENTS:
+		- uint a_uMovePercent -> chance out of 100
+		OUTPUT: ---
+		*/
+		void SetMovePercent(uint a_uMovePercent);
+		/*
+		USAGE: Sets the maximum level of the octree and quadtree runs
+		ARGUMENTS:
+		- uint a_uOctantLevels -> maximum level
+		OUTPUT: ---
+		*/
+		void SetOctantLevels(uint a_uOctantLevels);
+		/*
+		USAGE: Sets the proxy box margin of the entities in the runs
+		ARGUMENTS:
+		- float a_fProxyMargin -> distance the proxy boxes reach past the global boxes
+		OUTPUT: ---
+		*/
+		void SetProxyMargin(float a_fProxyMargin);
+		/*
+		USAGE: Gets the name of a scene
+		ARGUMENTS:
+		- uint a_uScene -> eBenchmarkScene
+		OUTPUT: name
+		*/
+		static String GetSceneName(uint a_uScene);
+		/*
+		USAGE: Gets the name of a broad phase
+		ARGUMENTS:
+		- uint a_uBroadPhase -> eBenchmarkBroadPhase
+		OUTPUT: name
+		*/
+		static String GetBroadPhaseName(uint a_uBroadPhase);
+
+	private:
+		/*
+		USAGE: Deallocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Release();
+		/*
+		USAGE: Allocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Init();
+		/*
+		USAGE: Picks the starting position and size of every entity and adds the entities to the entity manager
+		ARGUMENTS:
+		- uint a_uEntityCount -> number of entities in the scene
+		OUTPUT: ---
+		*/
+		void BuildScene(uint a_uEntityCount);
+		/*
+		USAGE: Moves some of the entities a short random step
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void MoveEntities();
+		/*
+		USAGE: Sets the model matrix of an entity from its position and size
+		ARGUMENTS:
+		- uint a_uIndex -> index of the entity
+		OUTPUT: ---
+		*/
+		void PlaceEntity(uint a_uIndex);
+	};
+}
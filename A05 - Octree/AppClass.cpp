@@ -18,21 +18,28 @@ void Application::InitVariables(void)
 #endif
 	int nSquare = static_cast<int>(std::sqrt(uInstances));
 	m_uObjects = nSquare * nSquare;
-	uint uIndex = -1;
+	std::vector<matrix4> lPosition;
 	for (int i = 0; i < nSquare; i++)
 	{
 		for (int j = 0; j < nSquare; j++)
 		{
-			uIndex++;
-			m_pEntityMngr->AddEntity("Minecraft\\Cube.obj");
 			vector3 v3Position = vector3(glm::sphericalRand(34.0f));
 			matrix4 m4Position = glm::translate(v3Position);
-			m_pEntityMngr->SetModelMatrix(m4Position);
+			lPosition.push_back(m4Position);
 		}
 	}
+	m_pEntityMngr->AddEntities("Minecraft\\Cube.obj", lPosition);
+	//entities that move less than a quarter unit stay where they are in every broad phase
+	m_pEntityMngr->SetProxyMargin(0.25f);
 	m_uOctantLevels = 1;
-	m_pRoot = new MyOctant(m_uOctantLevels, 5);
-	m_pEntityMngr->Update();
+	//The starting tree is read from the last run's snapshot when the scene has not changed
+	String sSnapshot = m_pSystem->m_pFolder->GetFolderRoot() + m_pSystem->GetAppName() + ".oct";
+	m_pOctantBuilder = new MyOctantBuilder(m_uOctantLevels, 5, m_uOctantFlags, sSnapshot);
+	m_pRoot = m_pOctantBuilder->GetTree();
+	m_pDynamicTree = new MyDynamicTree();
+	m_pSweepAndPrune = new MySweepAndPrune();
+	m_pHashGrid = new MyHashGrid();
+	m_pEntityMngr->Update(m_pRoot);
 }
 void Application::Update(void)
 {
@@ -45,8 +52,19 @@ void Application::Update(void)
 	//Is the first person camera active?
 	CameraRotation();
 	
-	//Update Entity Manager
-	m_pEntityMngr->Update();
+	//Swap in the octree built in the background if it is done
+	m_pOctantBuilder->Update();
+	m_pRoot = m_pOctantBuilder->GetTree();
+
+	//Update Entity Manager with the broad phase in use
+	if (m_uBroadPhase == 1)
+		m_pEntityMngr->Update(m_pDynamicTree);
+	else if (m_uBroadPhase == 2)
+		m_pEntityMngr->Update(m_pSweepAndPrune);
+	else if (m_uBroadPhase == 3)
+		m_pEntityMngr->Update(m_pHashGrid);
+	else
+		m_pEntityMngr->Update(m_pRoot);
 
 	//Add objects to render list
 	m_pEntityMngr->AddEntityToRenderList(-1, true);
@@ -56,8 +74,15 @@ void Application::Display(void)
 	// Clear the screen
 	ClearScreen();
 
-	//display octree
-	m_pRoot->Display();
+	//display the broad phase in use
+	if (m_uBroadPhase == 1)
+		m_pDynamicTree->Display(C_BLUE);
+	else if (m_uBroadPhase == 2)
+		m_pSweepAndPrune->Display(C_RED);
+	else if (m_uBroadPhase == 3)
+		m_pHashGrid->Display(C_GREEN);
+	else
+		m_pRoot->Display();
 	
 	// draw a skybox
 	m_pMeshMngr->AddSkyboxToRenderList();
@@ -76,7 +101,13 @@ void Application::Display(void)
 }
 void Application::Release(void)
 {
-	SafeDelete(m_pRoot);
+	SafeDelete(m_pOctantBuilder);
+	SafeDelete(m_pDynamicTree);
+	SafeDelete(m_pSweepAndPrune);
+	SafeDelete(m_pHashGrid);
+	m_pRoot = nullptr;
+	//the trees are gone, so no build is using the worker threads
+	MyWorkerPool::ReleaseInstance();
 	//release GUI
 	ShutdownGUI();
 }
\ No newline at end of file
@@ -12,6 +12,11 @@ Date: 2017/06
 
 #include "MyEntityManager.h"
 #include "MyOctant.h"
+#include "MyOctantBuilder.h"
+#include "MyDynamicTree.h"
+#include "MySweepAndPrune.h"
+#include "MyHashGrid.h"
+#include "MyWorkerPool.h"
 
 namespace Simplex
 {
@@ -19,10 +24,16 @@ namespace Simplex
 class Application
 {
 	MyEntityManager* m_pEntityMngr = nullptr; //Entity Manager
-	MyOctant* m_pRoot = nullptr; //root of the octree
+	MyOctantBuilder* m_pOctantBuilder = nullptr; //rebuilds the octree in the background
+	MyOctant* m_pRoot = nullptr; //root of the octree, owned by m_pOctantBuilder
+	MyDynamicTree* m_pDynamicTree = nullptr; //dynamic AABB tree over the entities
+	MySweepAndPrune* m_pSweepAndPrune = nullptr; //sweep and prune over the entities
+	MyHashGrid* m_pHashGrid = nullptr; //hashed uniform grid over the entities
+	uint m_uBroadPhase = 0; //broad phase in use (0 octree, 1 dynamic AABB tree, 2 sweep and prune, 3 hash grid)
 	uint m_uOctantID = -1; //Index of Octant to display
 	uint m_uObjects = 0; //Number of objects in the scene
 	uint m_uOctantLevels = 0; //Number of levels in the octree
+	uint m_uOctantFlags = OCTANT_SPARSE; //eOctantFlags the octree is built with, M toggles OCTANT_ADAPTIVE
 private:
 	String m_sProgrammer = "Alberto Bobadilla - labigm@rit.edu"; //programmer
 
@@ -124,21 +124,24 @@ void Application::ProcessKeyReleased(sf::Event a_event)
 	case sf::Keyboard::Add:
 		if (m_uOctantLevels < 4)
 		{
-			m_pEntityMngr->ClearDimensionSetAll();
 			++m_uOctantLevels;
-			SafeDelete(m_pRoot);
-			m_pRoot = new MyOctant(m_uOctantLevels, 5);
+			m_pOctantBuilder->Rebuild(m_uOctantLevels, 5, m_uOctantFlags);
 		}
 		break;
 	case sf::Keyboard::Subtract:
 		if (m_uOctantLevels > 0)
 		{
-			m_pEntityMngr->ClearDimensionSetAll();
 			--m_uOctantLevels;
-			SafeDelete(m_pRoot);
-			m_pRoot = new MyOctant(m_uOctantLevels, 5);
+			m_pOctantBuilder->Rebuild(m_uOctantLevels, 5, m_uOctantFlags);
 		}
 		break;
+	case sf::Keyboard::B:
+		m_uBroadPhase = (m_uBroadPhase + 1) % 4;
+		break;
+	case sf::Keyboard::M:
+		m_uOctantFlags ^= OCTANT_ADAPTIVE;
+		m_pOctantBuilder->Rebuild(m_uOctantLevels, 5, m_uOctantFlags);
+		break;
 	case sf::Keyboard::LShift:
 	case sf::Keyboard::RShift:
 		m_bModifier = false;
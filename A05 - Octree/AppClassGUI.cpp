@@ -39,7 +39,7 @@ void Application::DrawGUI(void)
 			ImGui::Text("FrameRate: %.2f [FPS] -> %.3f [ms/frame]\n",
 				ImGui::GetIO().Framerate, 1000.0f / ImGui::GetIO().Framerate);
 			ImGui::Text("Levels in Octree: %d\n", m_uOctantLevels);
-			//ImGui::Text("Octants: %d\n", m_pRoot->GetOctantCount());
+			ImGui::Text("Octants: %d\n", m_pRoot->GetOctantCount());
 			ImGui::Text("Objects: %d\n", m_uObjects);
 			ImGui::Separator();
 			ImGui::Text("Control:\n");
@@ -54,8 +54,46 @@ void Application::DrawGUI(void)
 			ImGui::Separator();
 			ImGui::Text("	  -: Increment Octree subdivision\n");
 			ImGui::Text("	  +: Decrement Octree subdivision\n");
+			ImGui::Text("	  B: Switch Octree / AABB tree / Sweep / Grid\n");
+			ImGui::Text("	  M: Toggle adaptive Octree subdivision\n");
 			ImGui::Separator();
-			ImGui::TextColored(ImColor(255, 255, 0), "Octree\n");
+			if (m_uBroadPhase == 0)
+			{
+				ImGui::TextColored(ImColor(255, 255, 0), (m_uOctantFlags & OCTANT_ADAPTIVE) ? "Octree (adaptive)\n" : "Octree\n");
+				MyOctantStats const& stats = m_pRoot->GetStats();
+				ImGui::Text("Build: %.3f [ms] Update: %.3f [ms] (%d moved)\n",
+					stats.m_fBuildTime, stats.m_fUpdateTime, stats.m_uMovedCount);
+				ImGui::Text("Pairs: %.3f [ms] %llu tested, %d candidates, %d colliding\n",
+					stats.m_fPairTime, stats.m_uTestedPairCount, stats.m_uCandidatePairCount, m_pEntityMngr->GetCollidingPairCount());
+				ImGui::Text("Entries: %d Straddlers: %d\n", stats.m_uEntryCount, stats.m_uStraddlerCount);
+				for (uint i = 0; i < stats.m_lLevelNodeCount.size(); ++i)
+				{
+					ImGui::Text("   Level %d: %d nodes, %d leafs\n", i, stats.m_lLevelNodeCount[i], stats.m_lLevelLeafCount[i]);
+				}
+				ImGui::Text("Leafs by entity count:\n");
+				ImGui::Text("   0: %d  1: %d  2: %d  3-4: %d\n",
+					stats.m_uOccupancy[0], stats.m_uOccupancy[1], stats.m_uOccupancy[2], stats.m_uOccupancy[3]);
+				ImGui::Text("   5-8: %d  9-16: %d  17-32: %d  33+: %d\n",
+					stats.m_uOccupancy[4], stats.m_uOccupancy[5], stats.m_uOccupancy[6], stats.m_uOccupancy[7]);
+			}
+			else if (m_uBroadPhase == 1)
+			{
+				ImGui::TextColored(ImColor(0, 0, 255), "Dynamic AABB tree\n");
+				ImGui::Text("Nodes: %d Height: %d\n", m_pDynamicTree->GetNodeCount(), m_pDynamicTree->GetHeight());
+				ImGui::Text("Colliding pairs: %d\n", m_pEntityMngr->GetCollidingPairCount());
+			}
+			else if (m_uBroadPhase == 2)
+			{
+				ImGui::TextColored(ImColor(255, 0, 0), "Sweep and prune\n");
+				ImGui::Text("Swaps: %d Overlapping pairs: %d\n", m_pSweepAndPrune->GetSwapCount(), m_pSweepAndPrune->GetPairCount());
+				ImGui::Text("Colliding pairs: %d\n", m_pEntityMngr->GetCollidingPairCount());
+			}
+			else
+			{
+				ImGui::TextColored(ImColor(0, 255, 0), "Hash grid\n");
+				ImGui::Text("Cell size: %.2f Cells: %d Oversize: %d\n", m_pHashGrid->GetCellSize(), m_pHashGrid->GetCellCount(), m_pHashGrid->GetOversizeCount());
+				ImGui::Text("Colliding pairs: %d\n", m_pEntityMngr->GetCollidingPairCount());
+			}
 		}
 		ImGui::End();
 	}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "MyEntityManager.h"
+
+namespace Simplex
+{
+	//Structure that picks the pairs of entities worth a collision check, MyEntityManager::Update talks
+	//to the structure only through this interface
+	class MyBroadPhase
+	{
+	public:
+		/*
+		USAGE: Destructor
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		virtual ~MyBroadPhase() {}
+		/*
+		USAGE: Brings the structure up to date with the current bounds of the entities in the entity manager
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		virtual void UpdateEntities() = 0;
+		/*
+		USAGE: Lists each pair of entities whose proxy boxes overlap exactly once
+		ARGUMENTS:
+		- std::vector<std::pair<uint, uint>>& a_lPair -> output, pairs of entity indices (lower index first)
+		OUTPUT: ---
+		*/
+		virtual void GetCandidatePairs(std::vector<std::pair<uint, uint>>& a_lPair) = 0;
+		/*
+		USAGE: Displays the volumes of the structure in the color specified
+		ARGUMENTS:
+		- vector3 a_v3Color = C_YELLOW -> color of the volumes to display
+		OUTPUT: ---
+		*/
+		virtual void Display(vector3 a_v3Color = C_YELLOW) = 0;
+		/*
+		USAGE: Gets the memory the structure holds on to, the capacity of its arrays included
+		ARGUMENTS: ---
+		OUTPUT: bytes
+		*/
+		virtual size_t GetMemoryUsage() = 0;
+	};
+}
@@ -0,0 +1,486 @@
+#include "MyDynamicTree.h"
+using namespace Simplex;
+
+const uint MyDynamicTree::NULL_NODE;
+
+//Constructor for the tree
+MyDynamicTree::MyDynamicTree()
+{
+	Init();
+	UpdateEntities();
+}
+
+//Copy constructor for the tree
+MyDynamicTree::MyDynamicTree(MyDynamicTree const& other)
+{
+	m_lNode = other.m_lNode;
+	m_uRoot = other.m_uRoot;
+	m_uFreeNode = other.m_uFreeNode;
+	m_uNodeCount = other.m_uNodeCount;
+	m_lLeaf = other.m_lLeaf;
+	m_lEntityMin = other.m_lEntityMin;
+	m_lEntityMax = other.m_lEntityMax;
+	m_pMeshMngr = MeshManager::GetInstance();
+	m_pEntityMngr = MyEntityManager::GetInstance();
+}
+
+//Copy assignment operator for the tree
+MyDynamicTree& MyDynamicTree::operator=(MyDynamicTree const& other)
+{
+	if(this != &other)
+	{
+		Release();
+		Init();
+		MyDynamicTree tree(other);
+		Swap(tree);
+	}
+	return *this;
+}
+
+//Destructor for the tree
+MyDynamicTree::~MyDynamicTree()
+{
+	Release();
+}
+
+//Swaps the values of the tree with the values of the one passed in
+void MyDynamicTree::Swap(MyDynamicTree& other)
+{
+	std::swap(m_lNode, other.m_lNode);
+	std::swap(m_uRoot, other.m_uRoot);
+	std::swap(m_uFreeNode, other.m_uFreeNode);
+	std::swap(m_uNodeCount, other.m_uNodeCount);
+	std::swap(m_lLeaf, other.m_lLeaf);
+	std::swap(m_lEntityMin, other.m_lEntityMin);
+	std::swap(m_lEntityMax, other.m_lEntityMax);
+	m_pMeshMngr = MeshManager::GetInstance();
+	m_pEntityMngr = MyEntityManager::GetInstance();
+}
+
+//Updates the entities that were added or moved
+void MyDynamicTree::UpdateEntities()
+{
+	uint entityCount = m_pEntityMngr->GetEntityCount();
+	//Removed entities shift the indices of the others, so only a rebuild can follow them
+	if(entityCount < m_lLeaf.size())
+	{
+		Release();
+		Init();
+	}
+	m_lEntityMin.resize(entityCount);
+	m_lEntityMax.resize(entityCount);
+	std::vector<vector3> const& lProxyMin = m_pEntityMngr->GetProxyMinList();
+	std::vector<vector3> const& lProxyMax = m_pEntityMngr->GetProxyMaxList();
+	for(uint i = 0; i < entityCount; i++)
+	{
+		m_lEntityMin[i] = lProxyMin[i];
+		m_lEntityMax[i] = lProxyMax[i];
+		if(i >= m_lLeaf.size())
+		{
+			m_lLeaf.push_back(CreateLeaf(i));
+			continue;
+		}
+		//The proxy boxes absorb small movements, only an entity whose proxy box changed is moved
+		MyDynamicTreeNode const& leaf = m_lNode[m_lLeaf[i]];
+		if(IsContaining(leaf.m_v3Min, leaf.m_v3Max, m_lEntityMin[i], m_lEntityMax[i]))
+		{
+			continue;
+		}
+		RemoveLeaf(m_lLeaf[i]);
+		ReleaseNode(m_lLeaf[i]);
+		m_lLeaf[i] = CreateLeaf(i);
+	}
+}
+
+//Lists the pairs of entities whose bounds overlap
+void MyDynamicTree::GetCandidatePairs(std::vector<std::pair<uint, uint>>& a_lPair)
+{
+	a_lPair.clear();
+	if(m_uRoot == NULL_NODE)
+	{
+		return;
+	}
+	uint entityCount = m_lLeaf.size();
+	for(uint first = 0; first < entityCount; first++)
+	{
+		vector3 minimum = m_lEntityMin[first];
+		vector3 maximum = m_lEntityMax[first];
+		m_lStack.clear();
+		m_lStack.push_back(m_uRoot);
+		while(m_lStack.size() > 0)
+		{
+			uint node = m_lStack.back();
+			m_lStack.pop_back();
+			if(!IsOverlapping(minimum, maximum, m_lNode[node].m_v3Min, m_lNode[node].m_v3Max))
+			{
+				continue;
+			}
+			if(!IsLeaf(node))
+			{
+				m_lStack.push_back(m_lNode[node].m_uChild[0]);
+				m_lStack.push_back(m_lNode[node].m_uChild[1]);
+				continue;
+			}
+			//Keeping the higher index lists a pair once, the leaf keeps the proxy box it was inserted with,
+			//which can be larger than the current one
+			uint second = m_lNode[node].m_uEntity;
+			if(second > first && IsOverlapping(minimum, maximum, m_lEntityMin[second], m_lEntityMax[second]))
+			{
+				a_lPair.push_back(std::make_pair(first, second));
+			}
+		}
+	}
+}
+
+//Displays every node of the tree
+void MyDynamicTree::Display(vector3 a_v3Color)
+{
+	uint nodeCount = m_lNode.size();
+	for(uint i = 0; i < nodeCount; i++)
+	{
+		MyDynamicTreeNode& node = m_lNode[i];
+		if(node.m_nHeight < 0)
+		{
+			continue;
+		}
+		vector3 center = (node.m_v3Min + node.m_v3Max) / 2.0f;
+		m_pMeshMngr->AddWireCubeToRenderList(glm::translate(IDENTITY_M4, center) * glm::scale(node.m_v3Max - node.m_v3Min), a_v3Color, RENDER_WIRE);
+	}
+}
+
+//Gets the memory the tree holds
+size_t MyDynamicTree::GetMemoryUsage()
+{
+	size_t memory = sizeof(MyDynamicTree);
+	memory += m_lNode.capacity() * sizeof(MyDynamicTreeNode);
+	memory += (m_lLeaf.capacity() + m_lStack.capacity()) * sizeof(uint);
+	memory += (m_lEntityMin.capacity() + m_lEntityMax.capacity()) * sizeof(vector3);
+	return memory;
+}
+
+//Finds the entities overlapping a box
+void MyDynamicTree::QueryBox(vector3 a_v3Min, vector3 a_v3Max, std::vector<uint>& a_lEntity)
+{
+	a_lEntity.clear();
+	if(m_uRoot == NULL_NODE)
+	{
+		return;
+	}
+	m_lStack.clear();
+	m_lStack.push_back(m_uRoot);
+	while(m_lStack.size() > 0)
+	{
+		uint node = m_lStack.back();
+		m_lStack.pop_back();
+		if(!IsOverlapping(a_v3Min, a_v3Max, m_lNode[node].m_v3Min, m_lNode[node].m_v3Max))
+		{
+			continue;
+		}
+		if(!IsLeaf(node))
+		{
+			m_lStack.push_back(m_lNode[node].m_uChild[0]);
+			m_lStack.push_back(m_lNode[node].m_uChild[1]);
+			continue;
+		}
+		uint entity = m_lNode[node].m_uEntity;
+		if(IsOverlapping(a_v3Min, a_v3Max, m_lEntityMin[entity], m_lEntityMax[entity]))
+		{
+			a_lEntity.push_back(entity);
+		}
+	}
+}
+
+//Gets the node count
+uint MyDynamicTree::GetNodeCount()
+{
+	return m_uNodeCount;
+}
+
+//Gets the height of the tree
+int MyDynamicTree::GetHeight()
+{
+	if(m_uRoot == NULL_NODE)
+	{
+		return 0;
+	}
+	return m_lNode[m_uRoot].m_nHeight;
+}
+
+//Release the tree (used in the destructor)
+void MyDynamicTree::Release()
+{
+	m_lNode.clear();
+	m_lLeaf.clear();
+	m_lEntityMin.clear();
+	m_lEntityMax.clear();
+	m_uRoot = NULL_NODE;
+	m_uFreeNode = NULL_NODE;
+	m_uNodeCount = 0;
+}
+
+//Initialize the tree without nodes
+void MyDynamicTree::Init()
+{
+	m_pMeshMngr = MeshManager::GetInstance();
+	m_pEntityMngr = MyEntityManager::GetInstance();
+	m_lNode.clear();
+	m_lLeaf.clear();
+	m_uRoot = NULL_NODE;
+	m_uFreeNode = NULL_NODE;
+	m_uNodeCount = 0;
+}
+
+//Takes a node from the pool
+uint MyDynamicTree::AllocateNode()
+{
+	uint node = m_uFreeNode;
+	if(node != NULL_NODE)
+	{
+		m_uFreeNode = m_lNode[node].m_uParent;
+	}
+	else
+	{
+		node = m_lNode.size();
+		m_lNode.push_back(MyDynamicTreeNode());
+	}
+	m_lNode[node] = MyDynamicTreeNode();
+	m_lNode[node].m_uParent = NULL_NODE;
+	m_lNode[node].m_uChild[0] = NULL_NODE;
+	m_lNode[node].m_uChild[1] = NULL_NODE;
+	m_uNodeCount++;
+	return node;
+}
+
+//Returns a node to the pool
+void MyDynamicTree::ReleaseNode(uint a_uNode)
+{
+	m_lNode[a_uNode].m_uParent = m_uFreeNode;
+	m_lNode[a_uNode].m_nHeight = -1;
+	m_uFreeNode = a_uNode;
+	m_uNodeCount--;
+}
+
+//Creates and inserts the leaf of an entity
+uint MyDynamicTree::CreateLeaf(uint a_uEntity)
+{
+	uint leaf = AllocateNode();
+	m_lNode[leaf].m_uEntity = a_uEntity;
+	m_lNode[leaf].m_v3Min = m_lEntityMin[a_uEntity];
+	m_lNode[leaf].m_v3Max = m_lEntityMax[a_uEntity];
+	InsertLeaf(leaf);
+	return leaf;
+}
+
+//Inserts a leaf in the tree
+void MyDynamicTree::InsertLeaf(uint a_uLeaf)
+{
+	if(m_uRoot == NULL_NODE)
+	{
+		m_uRoot = a_uLeaf;
+		m_lNode[a_uLeaf].m_uParent = NULL_NODE;
+		return;
+	}
+	//Walks down while going to a child is cheaper than hanging the leaf from the current node
+	vector3 leafMin = m_lNode[a_uLeaf].m_v3Min;
+	vector3 leafMax = m_lNode[a_uLeaf].m_v3Max;
+	uint sibling = m_uRoot;
+	while(!IsLeaf(sibling))
+	{
+		MyDynamicTreeNode const& node = m_lNode[sibling];
+		float area = GetArea(node.m_v3Min, node.m_v3Max);
+		float combinedArea = GetArea(glm::min(node.m_v3Min, leafMin), glm::max(node.m_v3Max, leafMax));
+		//Cost of a new parent for this node and the leaf
+		float cost = 2.0f * combinedArea;
+		//Every ancestor of the leaf grows by at least what this node grows
+		float inheritedCost = 2.0f * (combinedArea - area);
+		float childCost[2];
+		for(uint j = 0; j < 2; j++)
+		{
+			MyDynamicTreeNode const& child = m_lNode[node.m_uChild[j]];
+			childCost[j] = GetArea(glm::min(child.m_v3Min, leafMin), glm::max(child.m_v3Max, leafMax)) + inheritedCost;
+			if(!IsLeaf(node.m_uChild[j]))
+			{
+				childCost[j] -= GetArea(child.m_v3Min, child.m_v3Max);
+			}
+		}
+		if(cost < childCost[0] && cost < childCost[1])
+		{
+			break;
+		}
+		sibling = childCost[0] < childCost[1] ? node.m_uChild[0] : node.m_uChild[1];
+	}
+	//A new parent takes the place of the sibling
+	uint oldParent = m_lNode[sibling].m_uParent;
+	uint newParent = AllocateNode();
+	m_lNode[newParent].m_uParent = oldParent;
+	m_lNode[newParent].m_uChild[0] = sibling;
+	m_lNode[newParent].m_uChild[1] = a_uLeaf;
+	m_lNode[sibling].m_uParent = newParent;
+	m_lNode[a_uLeaf].m_uParent = newParent;
+	if(oldParent == NULL_NODE)
+	{
+		m_uRoot = newParent;
+	}
+	else if(m_lNode[oldParent].m_uChild[0] == sibling)
+	{
+		m_lNode[oldParent].m_uChild[0] = newParent;
+	}
+	else
+	{
+		m_lNode[oldParent].m_uChild[1] = newParent;
+	}
+	Refit(newParent);
+}
+
+//Removes a leaf from the tree
+void MyDynamicTree::RemoveLeaf(uint a_uLeaf)
+{
+	if(a_uLeaf == m_uRoot)
+	{
+		m_uRoot = NULL_NODE;
+		return;
+	}
+	uint parent = m_lNode[a_uLeaf].m_uParent;
+	uint grandParent = m_lNode[parent].m_uParent;
+	uint sibling = m_lNode[parent].m_uChild[0] == a_uLeaf ? m_lNode[parent].m_uChild[1] : m_lNode[parent].m_uChild[0];
+	m_lNode[sibling].m_uParent = grandParent;
+	ReleaseNode(parent);
+	if(grandParent == NULL_NODE)
+	{
+		m_uRoot = sibling;
+		return;
+	}
+	if(m_lNode[grandParent].m_uChild[0] == parent)
+	{
+		m_lNode[grandParent].m_uChild[0] = sibling;
+	}
+	else
+	{
+		m_lNode[grandParent].m_uChild[1] = sibling;
+	}
+	Refit(grandParent);
+}
+
+//Fits the nodes from a node to the root
+void MyDynamicTree::Refit(uint a_uNode)
+{
+	uint node = a_uNode;
+	while(node != NULL_NODE)
+	{
+		node = Balance(node);
+		FitNode(node);
+		node = m_lNode[node].m_uParent;
+	}
+}
+
+//Rotates the tree under a node when it leans to one side
+uint MyDynamicTree::Balance(uint a_uNode)
+{
+	uint a = a_uNode;
+	if(IsLeaf(a) || m_lNode[a].m_nHeight < 2)
+	{
+		return a;
+	}
+	//The higher child takes the place of the node, the node takes its lower grandchild
+	int balance = m_lNode[m_lNode[a].m_uChild[1]].m_nHeight - m_lNode[m_lNode[a].m_uChild[0]].m_nHeight;
+	if(balance >= -1 && balance <= 1)
+	{
+		return a;
+	}
+	uint side = balance > 1 ? 1 : 0;
+	uint up = m_lNode[a].m_uChild[side];
+	uint upHigh = m_lNode[up].m_uChild[0];
+	uint upLow = m_lNode[up].m_uChild[1];
+	if(m_lNode[upLow].m_nHeight > m_lNode[upHigh].m_nHeight)
+	{
+		std::swap(upHigh, upLow);
+	}
+	//The raised child hangs where the node was
+	uint parent = m_lNode[a].m_uParent;
+	m_lNode[up].m_uParent = parent;
+	if(parent == NULL_NODE)
+	{
+		m_uRoot = up;
+	}
+	else if(m_lNode[parent].m_uChild[0] == a)
+	{
+		m_lNode[parent].m_uChild[0] = up;
+	}
+	else
+	{
+		m_lNode[parent].m_uChild[1] = up;
+	}
+	//The node keeps its other child and takes the lower grandchild, the raised child keeps the higher one
+	m_lNode[a].m_uChild[side] = upLow;
+	m_lNode[upLow].m_uParent = a;
+	m_lNode[a].m_uParent = up;
+	m_lNode[up].m_uChild[0] = a;
+	m_lNode[up].m_uChild[1] = upHigh;
+	FitNode(a);
+	FitNode(up);
+	return up;
+}
+
+//Fits a node to its children
+void MyDynamicTree::FitNode(uint a_uNode)
+{
+	MyDynamicTreeNode& node = m_lNode[a_uNode];
+	if(node.m_uChild[0] == NULL_NODE)
+	{
+		return;
+	}
+	MyDynamicTreeNode const& first = m_lNode[node.m_uChild[0]];
+	MyDynamicTreeNode const& second = m_lNode[node.m_uChild[1]];
+	node.m_v3Min = glm::min(first.m_v3Min, second.m_v3Min);
+	node.m_v3Max = glm::max(first.m_v3Max, second.m_v3Max);
+	node.m_nHeight = 1 + std::max(first.m_nHeight, second.m_nHeight);
+}
+
+//Checks if a node is a leaf
+bool MyDynamicTree::IsLeaf(uint a_uNode)
+{
+	return m_lNode[a_uNode].m_uChild[0] == NULL_NODE;
+}
+
+//Measures the surface area of a box
+float MyDynamicTree::GetArea(vector3 a_v3Min, vector3 a_v3Max)
+{
+	vector3 size = a_v3Max - a_v3Min;
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+//Checks if a box is inside another
+bool MyDynamicTree::IsContaining(vector3 a_v3OuterMin, vector3 a_v3OuterMax, vector3 a_v3InnerMin, vector3 a_v3InnerMax)
+{
+	if(a_v3InnerMin.x < a_v3OuterMin.x || a_v3InnerMax.x > a_v3OuterMax.x)
+	{
+		return false;
+	}
+	if(a_v3InnerMin.y < a_v3OuterMin.y || a_v3InnerMax.y > a_v3OuterMax.y)
+	{
+		return false;
+	}
+	if(a_v3InnerMin.z < a_v3OuterMin.z || a_v3InnerMax.z > a_v3OuterMax.z)
+	{
+		return false;
+	}
+	return true;
+}
+
+//Checks if two boxes overlap
+bool MyDynamicTree::IsOverlapping(vector3 a_v3MinA, vector3 a_v3MaxA, vector3 a_v3MinB, vector3 a_v3MaxB)
+{
+	if(a_v3MaxA.x < a_v3MinB.x || a_v3MinA.x > a_v3MaxB.x)
+	{
+		return false;
+	}
+	if(a_v3MaxA.y < a_v3MinB.y || a_v3MinA.y > a_v3MaxB.y)
+	{
+		return false;
+	}
+	if(a_v3MaxA.z < a_v3MinB.z || a_v3MinA.z > a_v3MaxB.z)
+	{
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "MyBroadPhase.h"
+
+namespace Simplex
+{
+	//Node of the dynamic tree, leafs hold one entity and every other node has two children
+	struct MyDynamicTreeNode
+	{
+		vector3 m_v3Min = vector3(0.0f); //minimum of the fat bounds of the node
+		vector3 m_v3Max = vector3(0.0f); //maximum of the fat bounds of the node
+		uint m_uParent = 0; //index of the parent node, or of the next free node once the node is released
+		uint m_uChild[2] = { 0, 0 }; //indices of the children, NULL_NODE in a leaf
+		int m_nHeight = 0; //0 in a leaf, one more than the highest child otherwise, -1 once released
+		uint m_uEntity = 0; //index of the entity held by a leaf
+	};
+
+	//Bounding volume hierarchy over the proxy boxes of the entities, entities are inserted, removed and moved one
+	//at a time and the tree is kept balanced with rotations, so it works for any mix of entity sizes
+	class MyDynamicTree : public MyBroadPhase
+	{
+	public:
+		static const uint NULL_NODE = (uint)-1; //index that refers to no node
+
+	private:
+		MeshManager* m_pMeshMngr = nullptr; //mesh manager singleton
+		MyEntityManager* m_pEntityMngr = nullptr; //entity manager singleton
+
+		std::vector<MyDynamicTreeNode> m_lNode; //pool of nodes, released nodes are chained from m_uFreeNode
+		uint m_uRoot = NULL_NODE; //index of the root node
+		uint m_uFreeNode = NULL_NODE; //index of the first released node
+		uint m_uNodeCount = 0; //nodes in use
+
+		std::vector<uint> m_lLeaf; //leaf holding each entity
+		std::vector<vector3> m_lEntityMin; //minimum of each entity's proxy box at the last update
+		std::vector<vector3> m_lEntityMax; //maximum of each entity's proxy box at the last update
+		std::vector<uint> m_lStack; //nodes a search has yet to visit
+
+	public:
+		/*
+		USAGE: Constructor, inserts every entity the entity manager holds; the leafs use the proxy boxes
+		of the entities, so MyEntityManager::SetProxyMargin decides how far an entity moves before it
+		touches the tree
+		ARGUMENTS: ---
+		OUTPUT: class object
+		*/
+		MyDynamicTree();
+		/*
+		USAGE: Copy constructor
+		ARGUMENTS: class object to copy
+		OUTPUT: class object instance
+		*/
+		MyDynamicTree(MyDynamicTree const& other);
+		/*
+		USAGE: Copy assignment operator
+		ARGUMENTS: class object to copy
+		OUTPUT: ---
+		*/
+		MyDynamicTree& operator=(MyDynamicTree const& other);
+		/*
+		USAGE: Destructor
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		~MyDynamicTree();
+		/*
+		USAGE: Changes object contents for other object's
+		ARGUMENTS:
+		- MyDynamicTree& other -> object to swap content from
+		OUTPUT: ---
+		*/
+		void Swap(MyDynamicTree& other);
+		/*
+		USAGE: Inserts the entities added since the last update and moves the leafs of the entities that
+		left the bounds of their leafs; if entities were removed the tree is rebuilt
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		virtual void UpdateEntities() override;
+		/*
+		USAGE: Lists each pair of entities whose proxy boxes overlap exactly once, each entity looks for
+		the entities with a higher index in the leafs its bounds reach
+		ARGUMENTS:
+		- std::vector<std::pair<uint, uint>>& a_lPair -> output, pairs of entity indices (lower index first)
+		OUTPUT: ---
+		*/
+		virtual void GetCandidatePairs(std::vector<std::pair<uint, uint>>& a_lPair) override;
+		/*
+		USAGE: Displays the fat bounds of every node in the color specified
+		ARGUMENTS:
+		- vector3 a_v3Color = C_YELLOW -> color of the volumes to display
+		OUTPUT: ---
+		*/
+		virtual void Display(vector3 a_v3Color = C_YELLOW) override;
+		/*
+		USAGE: Gets the memory the tree holds on to, the capacity of its arrays included
+		ARGUMENTS: ---
+		OUTPUT: bytes
+		*/
+		virtual size_t GetMemoryUsage() override;
+		/*
+		USAGE: Finds the entities whose bounds at the last update overlap a box
+		ARGUMENTS:
+		- vector3 a_v3Min -> minimum of the box in global space
+		- vector3 a_v3Max -> maximum of the box in global space
+		- std::vector<uint>& a_lEntity -> output, indices of the entities
+		OUTPUT: ---
+		*/
+		void QueryBox(vector3 a_v3Min, vector3 a_v3Max, std::vector<uint>& a_lEntity);
+		/*
+		USAGE: Gets the number of nodes in use
+		ARGUMENTS: ---
+		OUTPUT: node count
+		*/
+		uint GetNodeCount();
+		/*
+		USAGE: Gets the height of the tree
+		ARGUMENTS: ---
+		OUTPUT: edges from the root to the deepest leaf
+		*/
+		int GetHeight();
+
+	private:
+		/*
+		USAGE: Deallocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Release();
+		/*
+		USAGE: Allocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Init();
+		/*
+		USAGE: Takes a node from the released nodes or from the end of the pool
+		ARGUMENTS: ---
+		OUTPUT: index of the node
+		*/
+		uint AllocateNode();
+		/*
+		USAGE: Chains a node to the released nodes
+		ARGUMENTS:
+		- uint a_uNode -> index of the node
+		OUTPUT: ---
+		*/
+		void ReleaseNode(uint a_uNode);
+		/*
+		USAGE: Creates a leaf for an entity with the bounds of its proxy box and inserts it
+		ARGUMENTS:
+		- uint a_uEntity -> index of the entity
+		OUTPUT: index of the leaf
+		*/
+		uint CreateLeaf(uint a_uEntity);
+		/*
+		USAGE: Hangs a leaf next to the node where the surface area the tree gains is the smallest
+		ARGUMENTS:
+		- uint a_uLeaf -> index of the leaf
+		OUTPUT: ---
+		*/
+		void InsertLeaf(uint a_uLeaf);
+		/*
+		USAGE: Takes a leaf out of the tree, its sibling takes the place of their parent
+		ARGUMENTS:
+		- uint a_uLeaf -> index of the leaf
+		OUTPUT: ---
+		*/
+		void RemoveLeaf(uint a_uLeaf);
+		/*
+		USAGE: Walks from a node to the root balancing each node and fitting its bounds and height to
+		its children
+		ARGUMENTS:
+		- uint a_uNode -> index of the first node to fit
+		OUTPUT: ---
+		*/
+		void Refit(uint a_uNode);
+		/*
+		USAGE: Rotates the higher grandchild of a node up when the heights of its children differ by more than one
+		ARGUMENTS:
+		- uint a_uNode -> index of the node
+		OUTPUT: index of the node now in the place of a_uNode
+		*/
+		uint Balance(uint a_uNode);
+		/*
+		USAGE: Fits the bounds and the height of a node to its children
+		ARGUMENTS:
+		- uint a_uNode -> index of the node
+		OUTPUT: ---
+		*/
+		void FitNode(uint a_uNode);
+		/*
+		USAGE: Asks if a node is a leaf
+		ARGUMENTS:
+		- uint a_uNode -> index of the node
+		OUTPUT: is a leaf
+		*/
+		bool IsLeaf(uint a_uNode);
+		/*
+		USAGE: Measures the surface area of a box, what a node costs in the tree
+		ARGUMENTS:
+		- vector3 a_v3Min -> minimum of the box
+		- vector3 a_v3Max -> maximum of the box
+		OUTPUT: surface area
+		*/
+		static float GetArea(vector3 a_v3Min, vector3 a_v3Max);
+		/*
+		USAGE: Asks if a box is inside another
+		ARGUMENTS:
+		- vector3 a_v3OuterMin -> minimum of the outer box
+		- vector3 a_v3OuterMax -> maximum of the outer box
+		- vector3 a_v3InnerMin -> minimum of the inner box
+		- vector3 a_v3InnerMax -> maximum of the inner box
+		OUTPUT: inside
+		*/
+		static bool IsContaining(vector3 a_v3OuterMin, vector3 a_v3OuterMax, vector3 a_v3InnerMin, vector3 a_v3InnerMax);
+		/*
+		USAGE: Asks if two boxes overlap
+		ARGUMENTS:
+		- vector3 a_v3MinA -> minimum of the first box
+		- vector3 a_v3MaxA -> maximum of the first box
+		- vector3 a_v3MinB -> minimum of the second box
+		- vector3 a_v3MaxB -> maximum of the second box
+		OUTPUT: overlap
+		*/
+		static bool IsOverlapping(vector3 a_v3MinA, vector3 a_v3MaxA, vector3 a_v3MinB, vector3 a_v3MaxB);
+	};
+}
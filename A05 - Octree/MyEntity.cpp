@@ -1,6 +1,8 @@
 #include "MyEntity.h"
+#include "MyEntityManager.h"
 using namespace Simplex;
 std::map<String, MyEntity*> MyEntity::m_IDMap;
+std::map<String, MyModelAsset> MyEntity::m_AssetMap;
 //  Accessors
 matrix4 Simplex::MyEntity::GetModelMatrix(void){ return m_m4ToWorld; }
 void Simplex::MyEntity::SetModelMatrix(matrix4 a_m4ToWorld)
@@ -8,14 +10,19 @@ void Simplex::MyEntity::SetModelMatrix(matrix4 a_m4ToWorld)
 	if (!m_bInMemory)
 		return;
 
+	//the model is shared, so it only gets the matrix when the entity is drawn
 	m_m4ToWorld = a_m4ToWorld;
-	m_pModel->SetModelMatrix(m_m4ToWorld);
 	m_pRigidBody->SetModelMatrix(m_m4ToWorld);
+	//the manager keeps its own copy of the matrix and bounds for the collision loops
+	if (m_uHandle != MyEntityManager::INVALID_HANDLE)
+		MyEntityManager::GetInstance()->RefreshEntity(m_uHandle);
 }
 Model* Simplex::MyEntity::GetModel(void){return m_pModel;}
 MyRigidBody* Simplex::MyEntity::GetRigidBody(void){	return m_pRigidBody; }
 bool Simplex::MyEntity::IsInitialized(void){ return m_bInMemory; }
 String Simplex::MyEntity::GetUniqueID(void) { return m_sUniqueID; }
+Simplex::uint Simplex::MyEntity::GetHandle(void) { return m_uHandle; }
+void Simplex::MyEntity::SetHandle(uint a_uHandle) { m_uHandle = a_uHandle; }
 void Simplex::MyEntity::SetAxisVisible(bool a_bSetAxis) { m_bSetAxis = a_bSetAxis; }
 //  MyEntity
 void Simplex::MyEntity::Init(void)
@@ -25,9 +32,12 @@ void Simplex::MyEntity::Init(void)
 	m_bSetAxis = false;
 	m_pModel = nullptr;
 	m_pRigidBody = nullptr;
-	m_DimensionArray = nullptr;
+	m_DimensionArray = m_LocalDimensionArray;
+	m_nDimensionCapacity = LOCAL_DIMENSION_COUNT;
 	m_m4ToWorld = IDENTITY_M4;
 	m_sUniqueID = "";
+	m_sFileName = "";
+	m_uHandle = 0xFFFFFFFF;
 	m_nDimensionCount = 0;
 }
 void Simplex::MyEntity::Swap(MyEntity& other)
@@ -39,37 +49,62 @@ void Simplex::MyEntity::Swap(MyEntity& other)
 	std::swap(m_pMeshMngr, other.m_pMeshMngr);
 	std::swap(m_bInMemory, other.m_bInMemory);
 	std::swap(m_sUniqueID, other.m_sUniqueID);
+	std::swap(m_sFileName, other.m_sFileName);
+	std::swap(m_uHandle, other.m_uHandle);
 	std::swap(m_bSetAxis, other.m_bSetAxis);
 	std::swap(m_nDimensionCount, other.m_nDimensionCount);
+	std::swap(m_nDimensionCapacity, other.m_nDimensionCapacity);
+	//a set kept inside the entity has to keep pointing inside whichever entity now holds it
+	bool bLocal = m_DimensionArray == m_LocalDimensionArray;
+	bool bOtherLocal = other.m_DimensionArray == other.m_LocalDimensionArray;
 	std::swap(m_DimensionArray, other.m_DimensionArray);
+	std::swap(m_LocalDimensionArray, other.m_LocalDimensionArray);
+	if (bLocal)
+		other.m_DimensionArray = other.m_LocalDimensionArray;
+	if (bOtherLocal)
+		m_DimensionArray = m_LocalDimensionArray;
 }
 void Simplex::MyEntity::Release(void)
 {
 	m_pMeshMngr = nullptr;
-	//it is not the job of the entity to release the model, 
-	//it is for the mesh manager to do so.
-	m_pModel = nullptr;
-	if (m_DimensionArray)
+	//the model is shared with the other entities of the same file,
+	//the last one to let go of it releases it
+	if (m_pModel)
+	{
+		RemoveModelReference(m_sFileName);
+		m_pModel = nullptr;
+	}
+	if (m_DimensionArray != m_LocalDimensionArray)
 	{
 		delete[] m_DimensionArray;
-		m_DimensionArray = nullptr;
+		m_DimensionArray = m_LocalDimensionArray;
 	}
+	m_nDimensionCapacity = LOCAL_DIMENSION_COUNT;
+	m_nDimensionCount = 0;
 	SafeDelete(m_pRigidBody);
-	m_IDMap.erase(m_sUniqueID);
+	//only take the name out if it is this entity's, a copy shares the name without owning it
+	auto entity = m_IDMap.find(m_sUniqueID);
+	if (entity != m_IDMap.end() && entity->second == this)
+		m_IDMap.erase(entity);
 }
 //The big 3
 Simplex::MyEntity::MyEntity(String a_sFileName, String a_sUniqueID)
 {
 	Init();
-	m_pModel = new Model();
-	m_pModel->Load(a_sFileName);
+	MyModelAsset* pAsset = AddModelReference(a_sFileName);
 	//if the model is loaded
-	if (m_pModel->GetName() != "")
+	if (pAsset)
 	{
-		GenUniqueID(a_sUniqueID);
-		m_sUniqueID = a_sUniqueID;
-		m_IDMap[a_sUniqueID] = this;
-		m_pRigidBody = new MyRigidBody(m_pModel->GetVertexList()); //generate a rigid body
+		m_pModel = pAsset->m_pModel;
+		m_sFileName = a_sFileName;
+		//an entity without a name skips the name map
+		if (a_sUniqueID != "")
+		{
+			GenUniqueID(a_sUniqueID);
+			m_sUniqueID = a_sUniqueID;
+			m_IDMap[a_sUniqueID] = this;
+		}
+		m_pRigidBody = new MyRigidBody(*pAsset->m_pRigidBody); //generate a rigid body
 		m_bInMemory = true; //mark this entity as viable
 	}
 }
@@ -77,14 +112,22 @@ Simplex::MyEntity::MyEntity(MyEntity const& other)
 {
 	m_bInMemory = other.m_bInMemory;
 	m_pModel = other.m_pModel;
+	m_sFileName = other.m_sFileName;
 	//generate a new rigid body we do not share the same rigid body as we do the model
-	m_pRigidBody = new MyRigidBody(m_pModel->GetVertexList()); 
+	if (m_pModel)
+		m_pRigidBody = new MyRigidBody(*AddModelReference(m_sFileName)->m_pRigidBody);
 	m_m4ToWorld = other.m_m4ToWorld;
 	m_pMeshMngr = other.m_pMeshMngr;
 	m_sUniqueID = other.m_sUniqueID;
 	m_bSetAxis = other.m_bSetAxis;
 	m_nDimensionCount = other.m_nDimensionCount;
-	m_DimensionArray = other.m_DimensionArray;
+	//the dimensions are copied, a set too big for the entity gets its own array
+	if (m_nDimensionCount > LOCAL_DIMENSION_COUNT)
+	{
+		m_nDimensionCapacity = m_nDimensionCount;
+		m_DimensionArray = new uint[m_nDimensionCapacity];
+	}
+	memcpy(m_DimensionArray, other.m_DimensionArray, sizeof(uint) * m_nDimensionCount);
 
 }
 MyEntity& Simplex::MyEntity::operator=(MyEntity const& other)
@@ -106,7 +149,8 @@ void Simplex::MyEntity::AddToRenderList(bool a_bDrawRigidBody)
 	if (!m_bInMemory)
 		return;
 
-	//draw model
+	//draw model, with this entity's matrix as other entities share it
+	m_pModel->SetModelMatrix(m_m4ToWorld);
 	m_pModel->AddToRenderList();
 	
 	//draw rigid body
@@ -123,6 +167,46 @@ MyEntity* Simplex::MyEntity::GetEntity(String a_sUniqueID)
 	//if not found return nullptr, if found return it
 	return entity == m_IDMap.end() ? nullptr : entity->second;
 }
+Simplex::uint Simplex::MyEntity::GetModelCount(void) { return m_AssetMap.size(); }
+MyModelAsset* Simplex::MyEntity::AddModelReference(String a_sFileName)
+{
+	//if an entity already loaded the file share its model
+	auto asset = m_AssetMap.find(a_sFileName);
+	if (asset != m_AssetMap.end())
+	{
+		++asset->second.m_uReferenceCount;
+		return &asset->second;
+	}
+
+	//otherwise load it
+	Model* pModel = new Model();
+	pModel->Load(a_sFileName);
+	if (pModel->GetName() == "")
+	{
+		SafeDelete(pModel);
+		return nullptr;
+	}
+	MyModelAsset& newAsset = m_AssetMap[a_sFileName];
+	newAsset.m_pModel = pModel;
+	newAsset.m_pRigidBody = new MyRigidBody(pModel->GetVertexList());
+	newAsset.m_uReferenceCount = 1;
+	return &newAsset;
+}
+void Simplex::MyEntity::RemoveModelReference(String a_sFileName)
+{
+	auto asset = m_AssetMap.find(a_sFileName);
+	if (asset == m_AssetMap.end())
+		return;
+
+	//the last entity using the model releases it
+	--asset->second.m_uReferenceCount;
+	if (asset->second.m_uReferenceCount == 0)
+	{
+		SafeDelete(asset->second.m_pRigidBody);
+		SafeDelete(asset->second.m_pModel);
+		m_AssetMap.erase(asset);
+	}
+}
 void Simplex::MyEntity::GenUniqueID(String& a_sUniqueID)
 {
 	static uint index = 0;
@@ -139,25 +223,29 @@ void Simplex::MyEntity::GenUniqueID(String& a_sUniqueID)
 }
 void Simplex::MyEntity::AddDimension(uint a_uDimension)
 {
+	//the set is sorted, find where the dimension goes
+	uint* pEnd = m_DimensionArray + m_nDimensionCount;
+	uint* pEntry = std::lower_bound(m_DimensionArray, pEnd, a_uDimension);
 	//we need to check that this dimension is not already allocated in the list
-	if (IsInDimension(a_uDimension))
+	if (pEntry != pEnd && *pEntry == a_uDimension)
 		return;//it is, so there is no need to add
 
-	//insert the entry
-	uint* pTemp;
-	pTemp = new uint[m_nDimensionCount + 1];
-	if(m_DimensionArray)
+	//if the array is full double it
+	uint uPosition = static_cast<uint>(pEntry - m_DimensionArray);
+	if (m_nDimensionCount == m_nDimensionCapacity)
 	{
+		uint* pTemp = new uint[m_nDimensionCapacity * 2];
 		memcpy(pTemp, m_DimensionArray, sizeof(uint) * m_nDimensionCount);
-		delete[] m_DimensionArray;
-		m_DimensionArray = nullptr;
+		if (m_DimensionArray != m_LocalDimensionArray)
+			delete[] m_DimensionArray;
+		m_DimensionArray = pTemp;
+		m_nDimensionCapacity *= 2;
 	}
-	pTemp[m_nDimensionCount] = a_uDimension;
-	m_DimensionArray = pTemp;
 
+	//insert the entry, moving the bigger ones one place up
+	memmove(m_DimensionArray + uPosition + 1, m_DimensionArray + uPosition, sizeof(uint) * (m_nDimensionCount - uPosition));
+	m_DimensionArray[uPosition] = a_uDimension;
 	++m_nDimensionCount;
-
-	SortDimensions();
 }
 void Simplex::MyEntity::RemoveDimension(uint a_uDimension)
 {
@@ -165,47 +253,25 @@ void Simplex::MyEntity::RemoveDimension(uint a_uDimension)
 	if (m_nDimensionCount == 0)
 		return;
 
-	//we look one by one if its the one wanted
-	for (uint i = 0; i < m_nDimensionCount; i++)
-	{
-		if (m_DimensionArray[i] == a_uDimension)
-		{
-			//if it is, then we swap it with the last one and then we pop
-			std::swap(m_DimensionArray[i], m_DimensionArray[m_nDimensionCount - 1]);
-			uint* pTemp;
-			pTemp = new uint[m_nDimensionCount - 1];
-			if (m_DimensionArray)
-			{
-				memcpy(pTemp, m_DimensionArray, sizeof(uint) * (m_nDimensionCount-1));
-				delete[] m_DimensionArray;
-				m_DimensionArray = nullptr;
-			}
-			m_DimensionArray = pTemp;
-			
-			--m_nDimensionCount;
-			SortDimensions();
-			return;
-		}
-	}
+	//look for the dimension in the sorted set
+	uint* pEnd = m_DimensionArray + m_nDimensionCount;
+	uint* pEntry = std::lower_bound(m_DimensionArray, pEnd, a_uDimension);
+	if (pEntry == pEnd || *pEntry != a_uDimension)
+		return;
+
+	//move the bigger ones one place down, the array keeps its size for the next insert
+	memmove(pEntry, pEntry + 1, sizeof(uint) * (pEnd - pEntry - 1));
+	--m_nDimensionCount;
 }
 void Simplex::MyEntity::ClearDimensionSet(void)
 {
-	if (m_DimensionArray)
-	{
-		delete[] m_DimensionArray;
-		m_DimensionArray = nullptr;
-	}
+	//the array is kept, the octree fills the set again on its next update
 	m_nDimensionCount = 0;
 }
 bool Simplex::MyEntity::IsInDimension(uint a_uDimension)
 {
 	//see if the entry is in the set
-	for (uint i = 0; i < m_nDimensionCount; i++)
-	{
-		if (m_DimensionArray[i] == a_uDimension)
-			return true;
-	}
-	return false;
+	return std::binary_search(m_DimensionArray, m_DimensionArray + m_nDimensionCount, a_uDimension);
 }
 bool Simplex::MyEntity::SharesDimension(MyEntity* const a_pOther)
 {
@@ -220,14 +286,17 @@ bool Simplex::MyEntity::SharesDimension(MyEntity* const a_pOther)
 			return true;
 	}
 
-	//for each dimension on both Entities we check if there is a common dimension
-	for (uint i = 0; i < m_nDimensionCount; ++i)
+	//both sets are sorted, so walking them together finds a common dimension
+	uint i = 0;
+	uint j = 0;
+	while (i < m_nDimensionCount && j < a_pOther->m_nDimensionCount)
 	{
-		for (uint j = 0; j < a_pOther->m_nDimensionCount; j++)
-		{
-			if (m_DimensionArray[i] == a_pOther->m_DimensionArray[j])
-				return true; //as soon as we find one we know they share dimensionality
-		}
+		if (m_DimensionArray[i] == a_pOther->m_DimensionArray[j])
+			return true; //as soon as we find one we know they share dimensionality
+		if (m_DimensionArray[i] < a_pOther->m_DimensionArray[j])
+			++i;
+		else
+			++j;
 	}
 
 	//could not find a common dimension
@@ -249,8 +318,4 @@ bool Simplex::MyEntity::IsColliding(MyEntity* const other)
 void Simplex::MyEntity::ClearCollisionList(void)
 {
 	m_pRigidBody->ClearCollidingList();
-}
-void Simplex::MyEntity::SortDimensions(void)
-{
-	std::sort(m_DimensionArray, m_DimensionArray + m_nDimensionCount);
 }
\ No newline at end of file
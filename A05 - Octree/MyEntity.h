@@ -10,15 +10,31 @@ Date: 2017/07
 namespace Simplex
 {
 
+//Model loaded once and shared by every entity made from the same file
+struct MyModelAsset
+{
+	Model* m_pModel = nullptr; //shared model, entities set their model matrix on it before drawing
+	MyRigidBody* m_pRigidBody = nullptr; //rigid body in local space, copied by each entity instead of reading the vertices again
+	uint m_uReferenceCount = 0; //entities using the model
+};
+
 //System Class
 class MyEntity
 {
+public:
+	static const uint LOCAL_DIMENSION_COUNT = 4; //dimensions kept inside the entity before the set moves to the heap
+
+private:
 	bool m_bInMemory = false; //loaded flag
 	bool m_bSetAxis = false; //render axis flag
 	String m_sUniqueID = ""; //Unique identifier name
+	String m_sFileName = ""; //Name of the model file, key of the shared model
+	uint m_uHandle = 0xFFFFFFFF; //handle the entity manager gave this entity
 
 	uint m_nDimensionCount = 0; //tells how many dimensions this entity lives in
-	uint* m_DimensionArray = nullptr; //Dimensions on which this entity is located
+	uint m_nDimensionCapacity = LOCAL_DIMENSION_COUNT; //dimensions the array can hold before it needs to grow
+	uint m_LocalDimensionArray[LOCAL_DIMENSION_COUNT]; //storage of the first dimensions, most entities live in only a few
+	uint* m_DimensionArray = m_LocalDimensionArray; //Dimensions on which this entity is located, sorted
 
 	Model* m_pModel = nullptr; //Model associated with this MyEntity
 	MyRigidBody* m_pRigidBody = nullptr; //Rigid Body associated with this MyEntity
@@ -26,17 +42,19 @@ class MyEntity
 	matrix4 m_m4ToWorld = IDENTITY_M4; //Model matrix associated with this MyEntity
 	MeshManager* m_pMeshMngr = nullptr; //For rendering shapes
 
-	static std::map<String, MyEntity*> m_IDMap; //a map of the unique ID's
+	static std::map<String, MyEntity*> m_IDMap; //a map of the unique ID's, entities without a name are not in it
+	static std::map<String, MyModelAsset> m_AssetMap; //a map of the loaded models by file name
 
 public:
 	/*
 	Usage: Constructor that specifies the name attached to the MyEntity
 	Arguments:
 	-	String a_sFileName -> Name of the model to load
-	-	String a_sUniqueID -> Name wanted as identifier, if not available will generate one
+	-	String a_sUniqueID = "" -> Name wanted as identifier, if not available will generate one, if empty
+	the entity has no name
 	Output: class object instance
 	*/
-	MyEntity(String a_sFileName, String a_sUniqueID = "NA");
+	MyEntity(String a_sFileName, String a_sUniqueID = "");
 	/*
 	Usage: Copy Constructor
 	Arguments: class object to copy
@@ -68,13 +86,14 @@ public:
 	*/
 	matrix4 GetModelMatrix(void);
 	/*
-	USAGE: Sets the model matrix associated with this entity
+	USAGE: Sets the model matrix associated with this entity, and of its rigid body; an entity held by
+	the entity manager also updates the data the manager stored for it
 	ARGUMENTS: matrix4 a_m4ToWorld -> model matrix to set
 	OUTPUT: ---
 	*/
 	void SetModelMatrix(matrix4 a_m4ToWorld);
 	/*
-	USAGE: Gets the model associated with this entity
+	USAGE: Gets the model associated with this entity, shared by every entity loaded from the same file
 	ARGUMENTS: ---
 	OUTPUT: Model
 	*/
@@ -110,6 +129,12 @@ public:
 	*/
 	static MyEntity* GetEntity(String a_sUniqueID);
 	/*
+	USAGE: Gets the number of models loaded and shared by the entities
+	ARGUMENTS: ---
+	OUTPUT: model count
+	*/
+	static uint GetModelCount(void);
+	/*
 	USAGE: Will generate a unique id based on the name provided
 	ARGUMENTS: String& a_sUniqueID -> desired name
 	OUTPUT: will output though the argument
@@ -122,6 +147,18 @@ public:
 	*/
 	String GetUniqueID(void);
 	/*
+	USAGE: Gets the handle the entity manager gave this entity
+	ARGUMENTS: ---
+	OUTPUT: handle
+	*/
+	uint GetHandle(void);
+	/*
+	USAGE: Sets the handle of this entity, only the entity manager should call it
+	ARGUMENTS: uint a_uHandle -> handle
+	OUTPUT: ---
+	*/
+	void SetHandle(uint a_uHandle);
+	/*
 	USAGE: Sets the visibility of the axis of this MyEntity
 	ARGUMENTS: bool a_bSetAxis = true -> axis visible?
 	OUTPUT: ---
@@ -152,7 +189,7 @@ public:
 	*/
 	bool IsInDimension(uint a_uDimension);
 	/*
-	USAGE: Asks if this entity shares a dimension with the incoming one
+	USAGE: Asks if this entity shares a dimension with the incoming one, walking both sorted sets once
 	ARGUMENTS: MyEntity* const a_pOther -> queried entity
 	OUTPUT: shares at least one dimension?
 	*/
@@ -165,13 +202,6 @@ public:
 	*/
 	void ClearCollisionList(void);
 
-	/*
-	USAGE: Will sort the array of dimensions
-	ARGUMENTS: ---
-	OUTPUT: ---
-	*/
-	void SortDimensions(void);
-
 private:
 	/*
 	Usage: Deallocates member fields
@@ -185,6 +215,18 @@ private:
 	Output: ---
 	*/
 	void Init(void);
+	/*
+	Usage: Gets the shared model of a file, loading it if no entity uses it yet, and counts one more user
+	Arguments: String a_sFileName -> Name of the model to load
+	Output: shared model, nullptr if the file could not be loaded
+	*/
+	static MyModelAsset* AddModelReference(String a_sFileName);
+	/*
+	Usage: Counts one less user of the shared model of a file, the last user releases it
+	Arguments: String a_sFileName -> Name of the model
+	Output: ---
+	*/
+	static void RemoveModelReference(String a_sFileName);
 };//class
 
   //EXPIMP_TEMPLATE template class SimplexDLL std::vector<MyEntity>;
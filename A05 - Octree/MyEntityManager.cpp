@@ -1,10 +1,17 @@
 #include "MyEntityManager.h"
+#include "MyBroadPhase.h"
+#include <chrono>
 using namespace Simplex;
 //  MyEntityManager
 Simplex::MyEntityManager* Simplex::MyEntityManager::m_pInstance = nullptr;
+const Simplex::uint Simplex::MyEntityManager::HANDLE_SLOT_BITS;
+const Simplex::uint Simplex::MyEntityManager::HANDLE_SLOT_MASK;
+const Simplex::uint Simplex::MyEntityManager::HANDLE_GENERATION_MASK;
+const Simplex::uint Simplex::MyEntityManager::INVALID_HANDLE;
 void Simplex::MyEntityManager::Init(void)
 {
 	m_uEntityCount = 0;
+	m_uEntityCapacity = 0;
 	m_mEntityArray = nullptr;
 }
 void Simplex::MyEntityManager::Release(void)
@@ -14,8 +21,24 @@ void Simplex::MyEntityManager::Release(void)
 		MyEntity* pEntity = m_mEntityArray[uEntity];
 		SafeDelete(pEntity);
 	}
+	if (m_mEntityArray)
+	{
+		delete[] m_mEntityArray;
+	}
 	m_uEntityCount = 0;
+	m_uEntityCapacity = 0;
 	m_mEntityArray = nullptr;
+	m_lToWorld.clear();
+	m_lMinGlobal.clear();
+	m_lMaxGlobal.clear();
+	m_lCenterGlobal.clear();
+	m_lRadius.clear();
+	m_lHalfWidth.clear();
+	m_lProxyMin.clear();
+	m_lProxyMax.clear();
+	m_lHandleIndex.clear();
+	m_lHandleGeneration.clear();
+	m_lFreeHandleSlot.clear();
 }
 Simplex::MyEntityManager* Simplex::MyEntityManager::GetInstance()
 {
@@ -35,17 +58,67 @@ void Simplex::MyEntityManager::ReleaseInstance()
 }
 int Simplex::MyEntityManager::GetEntityIndex(String a_sUniqueID)
 {
-	//look one by one for the specified unique id
-	for (uint uIndex = 0; uIndex < m_uEntityCount; ++uIndex)
-	{
-		if (a_sUniqueID == m_mEntityArray[uIndex]->GetUniqueID())
-			return uIndex;
-	}
+	//the name table gives the entity and its handle gives the index
+	MyEntity* pTemp = MyEntity::GetEntity(a_sUniqueID);
 	//if not found return -1
-	return -1;
+	if (pTemp == nullptr)
+		return -1;
+	return GetHandleIndex(pTemp->GetHandle());
 }
 //Accessors
 Simplex::uint Simplex::MyEntityManager::GetEntityCount(void) {	return m_uEntityCount; }
+unsigned long long Simplex::MyEntityManager::GetCandidatePairCount(void) {	return m_uCandidatePairCount; }
+Simplex::uint Simplex::MyEntityManager::GetCollidingPairCount(void) {	return m_uCollidingPairCount; }
+float Simplex::MyEntityManager::GetUpdateTime(void) { return m_fUpdateTime; }
+float Simplex::MyEntityManager::GetPairTime(void) { return m_fPairTime; }
+float Simplex::MyEntityManager::GetCollisionTime(void) { return m_fCollisionTime; }
+std::vector<Simplex::matrix4> const& Simplex::MyEntityManager::GetModelMatrixList(void) { return m_lToWorld; }
+std::vector<Simplex::vector3> const& Simplex::MyEntityManager::GetMinGlobalList(void) { return m_lMinGlobal; }
+std::vector<Simplex::vector3> const& Simplex::MyEntityManager::GetMaxGlobalList(void) { return m_lMaxGlobal; }
+std::vector<Simplex::vector3> const& Simplex::MyEntityManager::GetCenterGlobalList(void) { return m_lCenterGlobal; }
+std::vector<float> const& Simplex::MyEntityManager::GetRadiusList(void) { return m_lRadius; }
+std::vector<Simplex::vector3> const& Simplex::MyEntityManager::GetHalfWidthList(void) { return m_lHalfWidth; }
+std::vector<Simplex::vector3> const& Simplex::MyEntityManager::GetProxyMinList(void) { return m_lProxyMin; }
+std::vector<Simplex::vector3> const& Simplex::MyEntityManager::GetProxyMaxList(void) { return m_lProxyMax; }
+void Simplex::MyEntityManager::ResizeEntityData(void)
+{
+	m_lToWorld.resize(m_uEntityCount);
+	m_lMinGlobal.resize(m_uEntityCount);
+	m_lMaxGlobal.resize(m_uEntityCount);
+	m_lCenterGlobal.resize(m_uEntityCount);
+	m_lRadius.resize(m_uEntityCount);
+	m_lHalfWidth.resize(m_uEntityCount);
+	m_lProxyMin.resize(m_uEntityCount);
+	m_lProxyMax.resize(m_uEntityCount);
+}
+void Simplex::MyEntityManager::StoreEntityData(uint a_uIndex)
+{
+	MyRigidBody* pRigidBody = m_mEntityArray[a_uIndex]->GetRigidBody();
+	m_lToWorld[a_uIndex] = m_mEntityArray[a_uIndex]->GetModelMatrix();
+	m_lMinGlobal[a_uIndex] = pRigidBody->GetMinGlobal();
+	m_lMaxGlobal[a_uIndex] = pRigidBody->GetMaxGlobal();
+	m_lCenterGlobal[a_uIndex] = pRigidBody->GetCenterGlobal();
+	m_lRadius[a_uIndex] = pRigidBody->GetRadius();
+	m_lHalfWidth[a_uIndex] = pRigidBody->GetHalfWidth();
+	m_lProxyMin[a_uIndex] = pRigidBody->GetProxyMin();
+	m_lProxyMax[a_uIndex] = pRigidBody->GetProxyMax();
+}
+void Simplex::MyEntityManager::RefreshEntity(uint a_uHandle)
+{
+	int nIndex = GetHandleIndex(a_uHandle);
+	//an entity the manager does not hold has nothing stored
+	if (nIndex < 0)
+		return;
+
+	StoreEntityData((uint)nIndex);
+}
+bool Simplex::MyEntityManager::IsOverlapping(uint a_uFirst, uint a_uSecond)
+{
+	//same test as MyRigidBody::IsColliding, without following the pointers to the rigid bodies
+	return m_lMaxGlobal[a_uFirst].x >= m_lMinGlobal[a_uSecond].x && m_lMinGlobal[a_uFirst].x <= m_lMaxGlobal[a_uSecond].x &&
+		m_lMaxGlobal[a_uFirst].y >= m_lMinGlobal[a_uSecond].y && m_lMinGlobal[a_uFirst].y <= m_lMaxGlobal[a_uSecond].y &&
+		m_lMaxGlobal[a_uFirst].z >= m_lMinGlobal[a_uSecond].z && m_lMinGlobal[a_uFirst].z <= m_lMaxGlobal[a_uSecond].z;
+}
 Simplex::Model* Simplex::MyEntityManager::GetModel(uint a_uIndex)
 {
 	//if the list is empty return
@@ -102,27 +175,27 @@ Simplex::matrix4 Simplex::MyEntityManager::GetModelMatrix(uint a_uIndex)
 	if (a_uIndex >= m_uEntityCount)
 		a_uIndex = m_uEntityCount - 1;
 
-	return m_mEntityArray[a_uIndex]->GetModelMatrix();
+	return m_lToWorld[a_uIndex];
 }
 Simplex::matrix4 Simplex::MyEntityManager::GetModelMatrix(String a_sUniqueID)
 {
-	//Get the entity
-	MyEntity* pTemp = MyEntity::GetEntity(a_sUniqueID);
+	//read the stored matrix, the same one the index overload returns
+	int nIndex = GetEntityIndex(a_sUniqueID);
 	//if the entity exists
-	if (pTemp)
+	if (nIndex >= 0)
 	{
-		return pTemp->GetModelMatrix();
+		return m_lToWorld[nIndex];
 	}
 	return IDENTITY_M4;
 }
 void Simplex::MyEntityManager::SetModelMatrix(matrix4 a_m4ToWorld, String a_sUniqueID)
 {
-	//Get the entity
-	MyEntity* pTemp = MyEntity::GetEntity(a_sUniqueID);
+	//the stored data of the entity needs its index
+	int nIndex = GetEntityIndex(a_sUniqueID);
 	//if the entity exists
-	if (pTemp)
+	if (nIndex >= 0)
 	{
-		pTemp->SetModelMatrix(a_m4ToWorld);
+		SetModelMatrix(a_m4ToWorld, (uint)nIndex);
 	}
 }
 void Simplex::MyEntityManager::SetAxisVisibility(bool a_bVisibility, uint a_uIndex)
@@ -157,6 +230,7 @@ void Simplex::MyEntityManager::SetModelMatrix(matrix4 a_m4ToWorld, uint a_uIndex
 	if (a_uIndex >= m_uEntityCount)
 		a_uIndex = m_uEntityCount - 1;
 
+	//the entity tells the manager to store its new data
 	m_mEntityArray[a_uIndex]->SetModelMatrix(a_m4ToWorld);
 }
 //The big 3
@@ -174,41 +248,165 @@ void Simplex::MyEntityManager::Update(void)
 	}
 
 	//check collisions
-	for (uint i = 0; i < m_uEntityCount - 1; i++)
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	m_uCollidingPairCount = 0;
+	for (uint i = 0; i + 1 < m_uEntityCount; i++)
 	{
 		for (uint j = i + 1; j < m_uEntityCount; j++)
 		{
-			m_mEntityArray[i]->IsColliding(m_mEntityArray[j]);
+			//the stored boxes rule out most pairs before the entities are touched
+			if (IsOverlapping(i, j) && m_mEntityArray[i]->IsColliding(m_mEntityArray[j]))
+				++m_uCollidingPairCount;
 		}
 	}
+	std::chrono::duration<float, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	//every pair, counted wide since the count of a large scene does not fit in 32 bits
+	m_uCandidatePairCount = (unsigned long long)m_uEntityCount * (m_uEntityCount - 1) / 2;
+	m_fUpdateTime = 0.0f;
+	m_fPairTime = 0.0f;
+	m_fCollisionTime = elapsed.count();
 }
-void Simplex::MyEntityManager::AddEntity(String a_sFileName, String a_sUniqueID)
+void Simplex::MyEntityManager::Update(MyBroadPhase* a_pBroadPhase)
+{
+	//without a broad phase every pair needs to be checked
+	if (a_pBroadPhase == nullptr)
+	{
+		Update();
+		return;
+	}
+
+	//Clear all collisions
+	for (uint i = 0; i < m_uEntityCount; i++)
+	{
+		m_mEntityArray[i]->ClearCollisionList();
+	}
+
+	//the broad phase already lists each overlapping pair once, so there is no need to ask for shared dimensions
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	a_pBroadPhase->UpdateEntities();
+	std::chrono::high_resolution_clock::time_point updated = std::chrono::high_resolution_clock::now();
+	a_pBroadPhase->GetCandidatePairs(m_lPair);
+	std::chrono::high_resolution_clock::time_point paired = std::chrono::high_resolution_clock::now();
+	uint uPairCount = m_lPair.size();
+	m_uCandidatePairCount = uPairCount;
+	m_uCollidingPairCount = 0;
+	for (uint i = 0; i < uPairCount; i++)
+	{
+		//proxy boxes can overlap while the global boxes do not, the stored boxes tell before the rigid bodies are touched
+		if (!IsOverlapping(m_lPair[i].first, m_lPair[i].second))
+			continue;
+		MyRigidBody* pFirst = m_mEntityArray[m_lPair[i].first]->GetRigidBody();
+		MyRigidBody* pSecond = m_mEntityArray[m_lPair[i].second]->GetRigidBody();
+		if (pFirst->IsColliding(pSecond))
+			++m_uCollidingPairCount;
+	}
+	std::chrono::duration<float, std::milli> updateTime = updated - start;
+	std::chrono::duration<float, std::milli> pairTime = paired - updated;
+	std::chrono::duration<float, std::milli> collisionTime = std::chrono::high_resolution_clock::now() - paired;
+	m_fUpdateTime = updateTime.count();
+	m_fPairTime = pairTime.count();
+	m_fCollisionTime = collisionTime.count();
+}
+Simplex::uint Simplex::MyEntityManager::AddEntity(String a_sFileName, String a_sUniqueID)
 {
 	//Create a temporal entity to store the object
 	MyEntity* pTemp = new MyEntity(a_sFileName, a_sUniqueID);
 	//if I was able to generate it add it to the list
-	if (pTemp->IsInitialized())
+	if (!pTemp->IsInitialized())
 	{
-		//create a new temp array with one extra entry
-		PEntity* tempArray = new PEntity[m_uEntityCount + 1];
-		//start from 0 to the current count
-		uint uCount = 0;
-		for (uint i = 0; i < m_uEntityCount; ++i)
-		{
-			tempArray[uCount] = m_mEntityArray[i];
-			++uCount;
-		}
-		tempArray[uCount] = pTemp;
-		//if there was an older array delete
-		if (m_mEntityArray)
+		SafeDelete(pTemp);
+		return INVALID_HANDLE;
+	}
+	//if the array is full double it, so adding n entities copies the list only about log n times
+	if (m_uEntityCount == m_uEntityCapacity)
+		ReserveEntities(m_uEntityCapacity > 0 ? m_uEntityCapacity * 2 : 16);
+	return AppendEntity(pTemp);
+}
+void Simplex::MyEntityManager::AddEntities(String a_sFileName, std::vector<matrix4> const& a_lToWorld, String a_sUniqueID)
+{
+	//the list grows once for all of them
+	uint uCount = a_lToWorld.size();
+	if (m_uEntityCount + uCount > m_uEntityCapacity)
+		ReserveEntities(std::max(m_uEntityCount + uCount, m_uEntityCapacity * 2));
+
+	for (uint i = 0; i < uCount; ++i)
+	{
+		MyEntity* pTemp = new MyEntity(a_sFileName, a_sUniqueID);
+		//if the model did not load none of the others will either
+		if (!pTemp->IsInitialized())
 		{
-			delete[] m_mEntityArray;
+			SafeDelete(pTemp);
+			return;
 		}
-		//make the member pointer the temp pointer
-		m_mEntityArray = tempArray;
-		//add one entity to the count
-		++m_uEntityCount;
+		pTemp->SetModelMatrix(a_lToWorld[i]);
+		if (AppendEntity(pTemp) == INVALID_HANDLE)
+			return;
+	}
+}
+Simplex::uint Simplex::MyEntityManager::AppendEntity(MyEntity* a_pEntity)
+{
+	//take a free handle slot or open a new one
+	uint uSlot;
+	if (!m_lFreeHandleSlot.empty())
+	{
+		uSlot = m_lFreeHandleSlot.back();
+		m_lFreeHandleSlot.pop_back();
+	}
+	else if (m_lHandleIndex.size() < HANDLE_SLOT_MASK)
+	{
+		uSlot = m_lHandleIndex.size();
+		m_lHandleIndex.push_back(INVALID_HANDLE);
+		m_lHandleGeneration.push_back(0);
+	}
+	else //every slot a handle can name is in use
+	{
+		SafeDelete(a_pEntity);
+		return INVALID_HANDLE;
 	}
+	uint uHandle = (m_lHandleGeneration[uSlot] << HANDLE_SLOT_BITS) | uSlot;
+	m_lHandleIndex[uSlot] = m_uEntityCount;
+	a_pEntity->SetHandle(uHandle);
+
+	m_mEntityArray[m_uEntityCount] = a_pEntity;
+	//add one entity to the count
+	++m_uEntityCount;
+	//use the same proxy box as the rest
+	if (m_fProxyMargin > 0.0f || m_fProxyVelocityScale > 0.0f)
+		a_pEntity->GetRigidBody()->SetProxyMargin(m_fProxyMargin, m_fProxyVelocityScale);
+	ResizeEntityData();
+	StoreEntityData(m_uEntityCount - 1);
+	return uHandle;
+}
+void Simplex::MyEntityManager::ReserveEntities(uint a_uCapacity)
+{
+	//the array never shrinks
+	if (a_uCapacity <= m_uEntityCapacity)
+		return;
+
+	//create a new temp array with the extra entries
+	PEntity* tempArray = new PEntity[a_uCapacity];
+	//start from 0 to the current count
+	for (uint i = 0; i < m_uEntityCount; ++i)
+	{
+		tempArray[i] = m_mEntityArray[i];
+	}
+	//if there was an older array delete
+	if (m_mEntityArray)
+	{
+		delete[] m_mEntityArray;
+	}
+	//make the member pointer the temp pointer
+	m_mEntityArray = tempArray;
+	m_uEntityCapacity = a_uCapacity;
+	//the stored entity data grows along
+	m_lToWorld.reserve(a_uCapacity);
+	m_lMinGlobal.reserve(a_uCapacity);
+	m_lMaxGlobal.reserve(a_uCapacity);
+	m_lCenterGlobal.reserve(a_uCapacity);
+	m_lRadius.reserve(a_uCapacity);
+	m_lHalfWidth.reserve(a_uCapacity);
+	m_lProxyMin.reserve(a_uCapacity);
+	m_lProxyMax.reserve(a_uCapacity);
 }
 void Simplex::MyEntityManager::RemoveEntity(uint a_uIndex)
 {
@@ -224,31 +422,69 @@ void Simplex::MyEntityManager::RemoveEntity(uint a_uIndex)
 	if (a_uIndex != m_uEntityCount - 1)
 	{
 		std::swap(m_mEntityArray[a_uIndex], m_mEntityArray[m_uEntityCount - 1]);
+		//the handle of the entity that moved follows it
+		m_lHandleIndex[m_mEntityArray[a_uIndex]->GetHandle() & HANDLE_SLOT_MASK] = a_uIndex;
+		m_lToWorld[a_uIndex] = m_lToWorld[m_uEntityCount - 1];
+		m_lMinGlobal[a_uIndex] = m_lMinGlobal[m_uEntityCount - 1];
+		m_lMaxGlobal[a_uIndex] = m_lMaxGlobal[m_uEntityCount - 1];
+		m_lCenterGlobal[a_uIndex] = m_lCenterGlobal[m_uEntityCount - 1];
+		m_lRadius[a_uIndex] = m_lRadius[m_uEntityCount - 1];
+		m_lHalfWidth[a_uIndex] = m_lHalfWidth[m_uEntityCount - 1];
+		m_lProxyMin[a_uIndex] = m_lProxyMin[m_uEntityCount - 1];
+		m_lProxyMax[a_uIndex] = m_lProxyMax[m_uEntityCount - 1];
 	}
 	
-	//and then pop the last one
-	//create a new temp array with one less entry
-	PEntity* tempArray = new PEntity[m_uEntityCount - 1];
-	//start from 0 to the current count
-	for (uint i = 0; i < m_uEntityCount - 1; ++i)
-	{
-		tempArray[i] = m_mEntityArray[i];
-	}
-	//if there was an older array delete
-	if (m_mEntityArray)
-	{
-		delete[] m_mEntityArray;
-	}
-	//make the member pointer the temp pointer
-	m_mEntityArray = tempArray;
-	//add one entity to the count
+	//and then pop the last one, the array keeps its size for the next entity added
+	//its handle slot is freed with a new generation so old copies of the handle stop resolving
+	MyEntity* pEntity = m_mEntityArray[m_uEntityCount - 1];
+	uint uSlot = pEntity->GetHandle() & HANDLE_SLOT_MASK;
+	m_lHandleIndex[uSlot] = INVALID_HANDLE;
+	m_lHandleGeneration[uSlot] = (m_lHandleGeneration[uSlot] + 1) & HANDLE_GENERATION_MASK;
+	m_lFreeHandleSlot.push_back(uSlot);
+	SafeDelete(pEntity);
+	m_mEntityArray[m_uEntityCount - 1] = nullptr;
 	--m_uEntityCount;
+	ResizeEntityData();
 }
 void Simplex::MyEntityManager::RemoveEntity(String a_sUniqueID)
 {
 	int nIndex = GetEntityIndex(a_sUniqueID);
+	//if not found there is nothing to remove
+	if (nIndex < 0)
+		return;
+	RemoveEntity((uint)nIndex);
+}
+void Simplex::MyEntityManager::RemoveEntityByHandle(uint a_uHandle)
+{
+	int nIndex = GetHandleIndex(a_uHandle);
+	//a stale handle names nothing
+	if (nIndex < 0)
+		return;
 	RemoveEntity((uint)nIndex);
 }
+Simplex::uint Simplex::MyEntityManager::GetHandle(uint a_uIndex)
+{
+	//if the list is empty return
+	if (m_uEntityCount == 0)
+		return INVALID_HANDLE;
+
+	//if the index is larger than the number of entries we are asking for the last one
+	if (a_uIndex >= m_uEntityCount)
+		a_uIndex = m_uEntityCount - 1;
+
+	return m_mEntityArray[a_uIndex]->GetHandle();
+}
+int Simplex::MyEntityManager::GetHandleIndex(uint a_uHandle)
+{
+	uint uSlot = a_uHandle & HANDLE_SLOT_MASK;
+	//the slot has to exist, hold an entity and be of the same generation as the handle
+	if (uSlot >= m_lHandleIndex.size() || m_lHandleIndex[uSlot] == INVALID_HANDLE)
+		return -1;
+	if (m_lHandleGeneration[uSlot] != a_uHandle >> HANDLE_SLOT_BITS)
+		return -1;
+	return m_lHandleIndex[uSlot];
+}
+bool Simplex::MyEntityManager::IsHandleValid(uint a_uHandle) { return GetHandleIndex(a_uHandle) >= 0; }
 Simplex::String Simplex::MyEntityManager::GetUniqueID(uint a_uIndex)
 {
 	//if the list is empty return
@@ -343,6 +579,16 @@ void Simplex::MyEntityManager::RemoveDimension(String a_sUniqueID, uint a_uDimen
 		pTemp->RemoveDimension(a_uDimension);
 	}
 }
+void Simplex::MyEntityManager::SetProxyMargin(float a_fMargin, float a_fVelocityScale)
+{
+	m_fProxyMargin = a_fMargin;
+	m_fProxyVelocityScale = a_fVelocityScale;
+	for (uint i = 0; i < m_uEntityCount; ++i)
+	{
+		m_mEntityArray[i]->GetRigidBody()->SetProxyMargin(a_fMargin, a_fVelocityScale);
+		StoreEntityData(i);
+	}
+}
 void Simplex::MyEntityManager::ClearDimensionSetAll(void)
 {
 	for (uint i = 0; i < m_uEntityCount; ++i)
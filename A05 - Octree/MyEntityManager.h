@@ -10,12 +10,42 @@ Date: 2017/07
 namespace Simplex
 {
 
+class MyBroadPhase;
+
 //System Class
 class MyEntityManager
 {
+public:
+	static const uint HANDLE_SLOT_BITS = 20; //low bits of a handle, the slot that holds the entity's index
+	static const uint HANDLE_SLOT_MASK = (1 << HANDLE_SLOT_BITS) - 1; //also the most slots there can be
+	static const uint HANDLE_GENERATION_MASK = (1 << (32 - HANDLE_SLOT_BITS)) - 1; //high bits, bumped when a slot is freed
+	static const uint INVALID_HANDLE = 0xFFFFFFFF; //handle of no entity
+
+private:
 	typedef MyEntity* PEntity; //MyEntity Pointer
 	uint m_uEntityCount = 0; //number of elements in the list
+	uint m_uEntityCapacity = 0; //number of elements the array can hold before it needs to grow
 	PEntity* m_mEntityArray = nullptr; //array of MyEntity pointers
+	//copies of the data the collision and broad phase loops read, indexed as the entity array
+	std::vector<matrix4> m_lToWorld; //model matrix of each entity
+	std::vector<vector3> m_lMinGlobal; //minimum of each entity's global box
+	std::vector<vector3> m_lMaxGlobal; //maximum of each entity's global box
+	std::vector<vector3> m_lCenterGlobal; //center of each entity in global space
+	std::vector<float> m_lRadius; //radius of each entity's bounding sphere
+	std::vector<vector3> m_lHalfWidth; //half the size of each entity's oriented box
+	std::vector<vector3> m_lProxyMin; //minimum of each entity's proxy box
+	std::vector<vector3> m_lProxyMax; //maximum of each entity's proxy box
+	std::vector<uint> m_lHandleIndex; //index in the entity list of each handle slot, INVALID_HANDLE if free
+	std::vector<uint> m_lHandleGeneration; //generation of each handle slot, only the handle of this generation resolves
+	std::vector<uint> m_lFreeHandleSlot; //handle slots of removed entities, used again first
+	std::vector<std::pair<uint, uint>> m_lPair; //candidate pairs of entity indices to check for collision
+	unsigned long long m_uCandidatePairCount = 0; //pairs checked for collision by the last update
+	uint m_uCollidingPairCount = 0; //pairs found colliding by the last update
+	float m_fUpdateTime = 0.0f; //milliseconds the broad phase took to catch up with the entities in the last update
+	float m_fPairTime = 0.0f; //milliseconds the broad phase took to list the candidate pairs in the last update
+	float m_fCollisionTime = 0.0f; //milliseconds the collision checks took in the last update
+	float m_fProxyMargin = 0.0f; //proxy box margin of every rigid body
+	float m_fProxyVelocityScale = 0.0f; //proxy box velocity scale of every rigid body
 	static MyEntityManager* m_pInstance; // Singleton pointer
 public:
 	/*
@@ -37,13 +67,57 @@ public:
 	*/
 	int GetEntityIndex(String a_sUniqueID);
 	/*
+	USAGE: Gets the handle of the entity indexed, the handle keeps naming the entity when removing
+	others changes its index
+	ARGUMENTS: uint a_uIndex -> index of the queried entry, if larger than the list asks for the last one
+	OUTPUT: handle, INVALID_HANDLE if the list is empty
+	*/
+	uint GetHandle(uint a_uIndex);
+	/*
+	USAGE: Gets the current index (from the list of entities) of the entity a handle names
+	ARGUMENTS: uint a_uHandle -> handle of the entity
+	OUTPUT: index from the list of entities, -1 if the entity was removed
+	*/
+	int GetHandleIndex(uint a_uHandle);
+	/*
+	USAGE: Asks if a handle still names an entity
+	ARGUMENTS: uint a_uHandle -> handle of the entity
+	OUTPUT: valid?
+	*/
+	bool IsHandleValid(uint a_uHandle);
+	/*
+	USAGE: Copies the matrix and bounds of an entity into the lists the collision loops and broad phases
+	read; MyEntity::SetModelMatrix calls it, so the stored data follows the entity however it is moved
+	ARGUMENTS: uint a_uHandle -> handle of the entity
+	OUTPUT: ---
+	*/
+	void RefreshEntity(uint a_uHandle);
+	/*
 	USAGE: Will add an entity to the list
 	ARGUMENTS:
 	-	String a_sFileName -> Name of the model to load
-	-	String a_sUniqueID -> Name wanted as identifier, if not available will generate one
+	-	String a_sUniqueID = "" -> Name wanted as identifier, if not available will generate one, if empty
+	the entity has no name
+	OUTPUT: handle of the new entity, INVALID_HANDLE if it could not be added
+	*/
+	uint AddEntity(String a_sFileName, String a_sUniqueID = "");
+	/*
+	USAGE: Will add an entity to the list for each model matrix, growing the list only once, the new
+	entities are at the end of the list in the order of the matrices
+	ARGUMENTS:
+	-	String a_sFileName -> Name of the model to load
+	-	std::vector<matrix4> const& a_lToWorld -> model matrix of each new entity
+	-	String a_sUniqueID = "" -> Name wanted as identifier, taken ones will get a number appended, if
+	empty the entities have no name and are only reached by index or handle
+	OUTPUT: ---
+	*/
+	void AddEntities(String a_sFileName, std::vector<matrix4> const& a_lToWorld, String a_sUniqueID = "");
+	/*
+	USAGE: Makes room for this many entities so adding them does not grow the list again
+	ARGUMENTS: uint a_uCapacity -> number of entities the list should hold
 	OUTPUT: ---
 	*/
-	void AddEntity(String a_sFileName, String a_sUniqueID = "NA");
+	void ReserveEntities(uint a_uCapacity);
 	/*
 	USAGE: Deletes the MyEntity Specified by unique ID and removes it from the list
 	ARGUMENTS: uint a_uIndex -> index of the queried entry, if < 0 asks for the last one added
@@ -57,6 +131,12 @@ public:
 	*/
 	void RemoveEntity(String a_sUniqueID);
 	/*
+	USAGE: Deletes the MyEntity the handle names and removes it from the list
+	ARGUMENTS: uint a_uHandle -> handle of the entity, nothing happens if it was already removed
+	OUTPUT: ---
+	*/
+	void RemoveEntityByHandle(uint a_uHandle);
+	/*
 	USAGE: Gets the uniqueID name of the entity indexed
 	ARGUMENTS: uint a_uIndex = -1 -> index of the queried entry, if < 0 asks for the last one added
 	OUTPUT: UniqueID of the entity, if the list is empty will return blank
@@ -75,6 +155,13 @@ public:
 	*/
 	void Update(void);
 	/*
+	USAGE: Will update the MyEntity manager checking only the pairs of entities the broad phase lists,
+	the broad phase is brought up to date with the entities first
+	ARGUMENTS: MyBroadPhase* a_pBroadPhase -> octree or other structure over the entities, if nullptr will check every pair
+	OUTPUT: ---
+	*/
+	void Update(MyBroadPhase* a_pBroadPhase);
+	/*
 	USAGE: Gets the model associated with this entity
 	ARGUMENTS: uint a_uIndex = -1 -> index in the list of entities; if less than 0 it will add it to the last in the list
 	OUTPUT: Model
@@ -87,13 +174,15 @@ public:
 	*/
 	Model* GetModel(String a_sUniqueID);
 	/*
-	USAGE: Gets the Rigid Body associated with this entity
+	USAGE: Gets the Rigid Body associated with this entity; move the entity instead of the rigid body,
+	the broad phases read the bounds the manager stored and do not see a change made to the rigid body
 	ARGUMENTS: uint a_uIndex = -1 -> index in the list of entities; if less than 0 it will add it to the last in the list
 	OUTPUT: Rigid Body
 	*/
 	MyRigidBody* GetRigidBody(uint a_uIndex = -1);
 	/*
-	USAGE: Gets the Rigid Body associated with this entity
+	USAGE: Gets the Rigid Body associated with this entity; move the entity instead of the rigid body,
+	the broad phases read the bounds the manager stored and do not see a change made to the rigid body
 	ARGUMENTS: String a_sUniqueID -> id of the queried entity
 	OUTPUT: Rigid Body
 	*/
@@ -191,6 +280,17 @@ public:
 	*/
 	void RemoveDimension(String a_sUniqueID, uint a_uDimension);
 	/*
+	USAGE: Sets how far the proxy boxes of the rigid bodies reach past their global boxes, for the
+	entities in the system and the ones added later; broad phases track the proxy boxes, so only
+	entities whose global box escapes its proxy box move in them
+	ARGUMENTS:
+	- float a_fMargin -> distance added on every side of the global box
+	- float a_fVelocityScale = 0.0f -> the proxy box is also stretched this many times the last
+	movement ahead of the entity
+	OUTPUT: ---
+	*/
+	void SetProxyMargin(float a_fMargin, float a_fVelocityScale = 0.0f);
+	/*
 	USAGE: will remove all dimensions from all entities
 	ARGUMENTS: ---
 	OUTPUT: ---
@@ -246,6 +346,85 @@ public:
 	OUTPUT: MyEntity count
 	*/
 	uint GetEntityCount(void);
+	/*
+	USAGE: Gets the model matrix of every entity, in the order of the entity list; entities moved
+	through the manager keep it up to date
+	ARGUMENTS: ---
+	OUTPUT: model matrices
+	*/
+	std::vector<matrix4> const& GetModelMatrixList(void);
+	/*
+	USAGE: Gets the minimum of the global box of every entity
+	ARGUMENTS: ---
+	OUTPUT: minimums
+	*/
+	std::vector<vector3> const& GetMinGlobalList(void);
+	/*
+	USAGE: Gets the maximum of the global box of every entity
+	ARGUMENTS: ---
+	OUTPUT: maximums
+	*/
+	std::vector<vector3> const& GetMaxGlobalList(void);
+	/*
+	USAGE: Gets the center in global space of every entity
+	ARGUMENTS: ---
+	OUTPUT: centers
+	*/
+	std::vector<vector3> const& GetCenterGlobalList(void);
+	/*
+	USAGE: Gets the bounding sphere radius of every entity
+	ARGUMENTS: ---
+	OUTPUT: radii
+	*/
+	std::vector<float> const& GetRadiusList(void);
+	/*
+	USAGE: Gets half the size of the oriented box of every entity
+	ARGUMENTS: ---
+	OUTPUT: half widths
+	*/
+	std::vector<vector3> const& GetHalfWidthList(void);
+	/*
+	USAGE: Gets the minimum of the proxy box of every entity
+	ARGUMENTS: ---
+	OUTPUT: minimums
+	*/
+	std::vector<vector3> const& GetProxyMinList(void);
+	/*
+	USAGE: Gets the maximum of the proxy box of every entity
+	ARGUMENTS: ---
+	OUTPUT: maximums
+	*/
+	std::vector<vector3> const& GetProxyMaxList(void);
+	/*
+	USAGE: Will return the count of pairs of entities checked for collision by the last update
+	ARGUMENTS: ---
+	OUTPUT: candidate pair count
+	*/
+	unsigned long long GetCandidatePairCount(void);
+	/*
+	USAGE: Will return the count of pairs of entities found colliding by the last update
+	ARGUMENTS: ---
+	OUTPUT: colliding pair count
+	*/
+	uint GetCollidingPairCount(void);
+	/*
+	USAGE: Will return the milliseconds the broad phase took to catch up with the entities in the last update
+	ARGUMENTS: ---
+	OUTPUT: milliseconds, 0 if the last update had no broad phase
+	*/
+	float GetUpdateTime(void);
+	/*
+	USAGE: Will return the milliseconds the broad phase took to list the candidate pairs in the last update
+	ARGUMENTS: ---
+	OUTPUT: milliseconds, 0 if the last update had no broad phase
+	*/
+	float GetPairTime(void);
+	/*
+	USAGE: Will return the milliseconds the collision checks took in the last update
+	ARGUMENTS: ---
+	OUTPUT: milliseconds
+	*/
+	float GetCollisionTime(void);
 private:
 	/*
 	Usage: constructor
@@ -283,6 +462,32 @@ private:
 	Output: ---
 	*/
 	void Init(void);
+	/*
+	Usage: adds a loaded entity at the end of the list and gives it a handle
+	Arguments: MyEntity* a_pEntity -> entity to add, the list needs room for it
+	Output: handle of the entity, INVALID_HANDLE if every handle is in use and the entity was deleted
+	*/
+	uint AppendEntity(MyEntity* a_pEntity);
+	/*
+	Usage: sizes the lists the collision loops read to the entity count
+	Arguments: ---
+	Output: ---
+	*/
+	void ResizeEntityData(void);
+	/*
+	Usage: copies the matrix and bounds of an entity into the lists the collision loops read
+	Arguments: uint a_uIndex -> index of the entity
+	Output: ---
+	*/
+	void StoreEntityData(uint a_uIndex);
+	/*
+	Usage: tells if the global boxes of two entities overlap, reading the stored bounds
+	Arguments:
+	-	uint a_uFirst -> index of one entity
+	-	uint a_uSecond -> index of the other entity
+	Output: overlapping?
+	*/
+	bool IsOverlapping(uint a_uFirst, uint a_uSecond);
 };//class
 
 } //namespace Simplex
@@ -0,0 +1,375 @@
+#include "MyHashGrid.h"
+using namespace Simplex;
+
+//Constructor for the hash grid
+MyHashGrid::MyHashGrid(float a_fCellSize)
+{
+	Init();
+	m_bAutoCellSize = a_fCellSize <= 0.0f;
+	if(!m_bAutoCellSize)
+	{
+		m_fCellSize = a_fCellSize;
+	}
+	UpdateEntities();
+}
+
+//Copy constructor for the hash grid
+MyHashGrid::MyHashGrid(MyHashGrid const& other)
+{
+	m_fCellSize = other.m_fCellSize;
+	m_bAutoCellSize = other.m_bAutoCellSize;
+	m_uStamp = other.m_uStamp;
+	m_lSlot = other.m_lSlot;
+	m_lUsedSlot = other.m_lUsedSlot;
+	m_lCellEntity = other.m_lCellEntity;
+	m_lOversize = other.m_lOversize;
+	m_lEntityMin = other.m_lEntityMin;
+	m_lEntityMax = other.m_lEntityMax;
+	m_pMeshMngr = MeshManager::GetInstance();
+	m_pEntityMngr = MyEntityManager::GetInstance();
+}
+
+//Copy assignment operator for the hash grid
+MyHashGrid& MyHashGrid::operator=(MyHashGrid const& other)
+{
+	if(this != &other)
+	{
+		Release();
+		Init();
+		MyHashGrid grid(other);
+		Swap(grid);
+	}
+	return *this;
+}
+
+//Destructor for the hash grid
+MyHashGrid::~MyHashGrid()
+{
+	Release();
+}
+
+//Swaps the values of the hash grid with the values of the one passed in
+void MyHashGrid::Swap(MyHashGrid& other)
+{
+	std::swap(m_fCellSize, other.m_fCellSize);
+	std::swap(m_bAutoCellSize, other.m_bAutoCellSize);
+	std::swap(m_uStamp, other.m_uStamp);
+	std::swap(m_lSlot, other.m_lSlot);
+	std::swap(m_lUsedSlot, other.m_lUsedSlot);
+	std::swap(m_lCellEntity, other.m_lCellEntity);
+	std::swap(m_lOversize, other.m_lOversize);
+	std::swap(m_lEntityMin, other.m_lEntityMin);
+	std::swap(m_lEntityMax, other.m_lEntityMax);
+	m_pMeshMngr = MeshManager::GetInstance();
+	m_pEntityMngr = MyEntityManager::GetInstance();
+}
+
+//Buckets every entity by the cells it reaches
+void MyHashGrid::UpdateEntities()
+{
+	uint entityCount = m_pEntityMngr->GetEntityCount();
+	bool resized = entityCount != m_lEntityMin.size();
+	m_lEntityMin = m_pEntityMngr->GetProxyMinList();
+	m_lEntityMax = m_pEntityMngr->GetProxyMaxList();
+	if(m_bAutoCellSize && resized)
+	{
+		FitCellSize();
+	}
+
+	//Counts the cells each entity reaches, the table holds twice the cells at most so probes stay short
+	m_lOversize.clear();
+	uint entryCount = 0;
+	for(uint i = 0; i < entityCount; i++)
+	{
+		int minX, minY, minZ, maxX, maxY, maxZ;
+		GetCell(m_lEntityMin[i], minX, minY, minZ);
+		GetCell(m_lEntityMax[i], maxX, maxY, maxZ);
+		unsigned long long cellCount = (unsigned long long)(maxX - minX + 1) * (maxY - minY + 1) * (maxZ - minZ + 1);
+		if(cellCount > MAX_ENTITY_CELLS)
+		{
+			m_lOversize.push_back(i);
+			continue;
+		}
+		entryCount += (uint)cellCount;
+	}
+	uint slotCount = 16;
+	while(slotCount < 2 * entryCount)
+	{
+		slotCount *= 2;
+	}
+	if(slotCount > m_lSlot.size())
+	{
+		m_lSlot.assign(slotCount, MyHashGridCell());
+		m_uStamp = 0;
+	}
+	//A new stamp empties every slot at once, only when it wraps around are the slots cleared
+	m_uStamp++;
+	if(m_uStamp == 0)
+	{
+		m_lSlot.assign(m_lSlot.size(), MyHashGridCell());
+		m_uStamp = 1;
+	}
+	m_lUsedSlot.clear();
+
+	//Counting sort of the entries by cell, first the size of each cell and then the entities
+	uint oversizeIndex = 0;
+	for(uint i = 0; i < entityCount; i++)
+	{
+		if(oversizeIndex < m_lOversize.size() && m_lOversize[oversizeIndex] == i)
+		{
+			oversizeIndex++;
+			continue;
+		}
+		int minX, minY, minZ, maxX, maxY, maxZ;
+		GetCell(m_lEntityMin[i], minX, minY, minZ);
+		GetCell(m_lEntityMax[i], maxX, maxY, maxZ);
+		for(int x = minX; x <= maxX; x++)
+		{
+			for(int y = minY; y <= maxY; y++)
+			{
+				for(int z = minZ; z <= maxZ; z++)
+				{
+					m_lSlot[FindSlot(x, y, z)].m_uCount++;
+				}
+			}
+		}
+	}
+	uint begin = 0;
+	uint usedCount = m_lUsedSlot.size();
+	for(uint i = 0; i < usedCount; i++)
+	{
+		MyHashGridCell& cell = m_lSlot[m_lUsedSlot[i]];
+		cell.m_uBegin = begin;
+		begin += cell.m_uCount;
+		cell.m_uCount = 0;
+	}
+	m_lCellEntity.resize(entryCount);
+	oversizeIndex = 0;
+	for(uint i = 0; i < entityCount; i++)
+	{
+		if(oversizeIndex < m_lOversize.size() && m_lOversize[oversizeIndex] == i)
+		{
+			oversizeIndex++;
+			continue;
+		}
+		int minX, minY, minZ, maxX, maxY, maxZ;
+		GetCell(m_lEntityMin[i], minX, minY, minZ);
+		GetCell(m_lEntityMax[i], maxX, maxY, maxZ);
+		for(int x = minX; x <= maxX; x++)
+		{
+			for(int y = minY; y <= maxY; y++)
+			{
+				for(int z = minZ; z <= maxZ; z++)
+				{
+					MyHashGridCell& cell = m_lSlot[FindSlot(x, y, z)];
+					m_lCellEntity[cell.m_uBegin + cell.m_uCount] = i;
+					cell.m_uCount++;
+				}
+			}
+		}
+	}
+}
+
+//Lists the overlapping pairs
+void MyHashGrid::GetCandidatePairs(std::vector<std::pair<uint, uint>>& a_lPair)
+{
+	a_lPair.clear();
+	uint usedCount = m_lUsedSlot.size();
+	for(uint i = 0; i < usedCount; i++)
+	{
+		MyHashGridCell const& cell = m_lSlot[m_lUsedSlot[i]];
+		uint end = cell.m_uBegin + cell.m_uCount;
+		for(uint j = cell.m_uBegin; j < end; j++)
+		{
+			for(uint k = j + 1; k < end; k++)
+			{
+				uint first = m_lCellEntity[j];
+				uint second = m_lCellEntity[k];
+				if(!IsOverlapping(first, second))
+				{
+					continue;
+				}
+				//Both entities reach the cell holding the corner of the overlap, only that cell reports the pair
+				int x, y, z;
+				GetCell(glm::max(m_lEntityMin[first], m_lEntityMin[second]), x, y, z);
+				if(x != cell.m_nX || y != cell.m_nY || z != cell.m_nZ)
+				{
+					continue;
+				}
+				a_lPair.push_back(std::make_pair(std::min(first, second), std::max(first, second)));
+			}
+		}
+	}
+	//Entities too big for the grid are checked against every entity, once per pair of them
+	uint oversizeCount = m_lOversize.size();
+	uint entityCount = m_lEntityMin.size();
+	for(uint i = 0; i < oversizeCount; i++)
+	{
+		uint oversize = m_lOversize[i];
+		uint oversizeIndex = 0;
+		for(uint j = 0; j < entityCount; j++)
+		{
+			bool isOversize = oversizeIndex < oversizeCount && m_lOversize[oversizeIndex] == j;
+			if(isOversize)
+			{
+				oversizeIndex++;
+			}
+			if(j == oversize || (isOversize && j < oversize))
+			{
+				continue;
+			}
+			if(IsOverlapping(oversize, j))
+			{
+				a_lPair.push_back(std::make_pair(std::min(oversize, j), std::max(oversize, j)));
+			}
+		}
+	}
+}
+
+//Displays the occupied cells
+void MyHashGrid::Display(vector3 a_v3Color)
+{
+	uint usedCount = m_lUsedSlot.size();
+	for(uint i = 0; i < usedCount; i++)
+	{
+		MyHashGridCell const& cell = m_lSlot[m_lUsedSlot[i]];
+		vector3 center = (vector3((float)cell.m_nX, (float)cell.m_nY, (float)cell.m_nZ) + vector3(0.5f)) * m_fCellSize;
+		m_pMeshMngr->AddWireCubeToRenderList(glm::translate(IDENTITY_M4, center) * glm::scale(vector3(m_fCellSize)), a_v3Color, RENDER_WIRE);
+	}
+}
+
+//Gets the memory the grid holds
+size_t MyHashGrid::GetMemoryUsage()
+{
+	size_t memory = sizeof(MyHashGrid);
+	memory += m_lSlot.capacity() * sizeof(MyHashGridCell);
+	memory += (m_lUsedSlot.capacity() + m_lCellEntity.capacity() + m_lOversize.capacity()) * sizeof(uint);
+	memory += (m_lEntityMin.capacity() + m_lEntityMax.capacity()) * sizeof(vector3);
+	memory += m_lHalfWidth.capacity() * sizeof(float);
+	return memory;
+}
+
+//Sets the cell size
+void MyHashGrid::SetCellSize(float a_fCellSize)
+{
+	m_bAutoCellSize = a_fCellSize <= 0.0f;
+	if(m_bAutoCellSize)
+	{
+		FitCellSize();
+	}
+	else
+	{
+		m_fCellSize = a_fCellSize;
+	}
+	UpdateEntities();
+}
+
+//Gets the cell size
+float MyHashGrid::GetCellSize()
+{
+	return m_fCellSize;
+}
+
+//Gets the occupied cell count
+uint MyHashGrid::GetCellCount()
+{
+	return m_lUsedSlot.size();
+}
+
+//Gets the oversize entity count
+uint MyHashGrid::GetOversizeCount()
+{
+	return m_lOversize.size();
+}
+
+//Release the hash grid (used in the destructor)
+void MyHashGrid::Release()
+{
+	m_lSlot.clear();
+	m_lUsedSlot.clear();
+	m_lCellEntity.clear();
+	m_lOversize.clear();
+	m_lEntityMin.clear();
+	m_lEntityMax.clear();
+	m_lHalfWidth.clear();
+}
+
+//Initialize the hash grid without entities
+void MyHashGrid::Init()
+{
+	m_pMeshMngr = MeshManager::GetInstance();
+	m_pEntityMngr = MyEntityManager::GetInstance();
+	m_fCellSize = 1.0f;
+	m_bAutoCellSize = true;
+	m_uStamp = 0;
+}
+
+//Fits the cell size to the entities
+void MyHashGrid::FitCellSize()
+{
+	uint entityCount = m_lEntityMin.size();
+	if(entityCount == 0)
+	{
+		return;
+	}
+	m_lHalfWidth.resize(entityCount);
+	for(uint i = 0; i < entityCount; i++)
+	{
+		vector3 halfWidth = (m_lEntityMax[i] - m_lEntityMin[i]) / 2.0f;
+		m_lHalfWidth[i] = std::max(halfWidth.x, std::max(halfWidth.y, halfWidth.z));
+	}
+	std::nth_element(m_lHalfWidth.begin(), m_lHalfWidth.begin() + entityCount / 2, m_lHalfWidth.end());
+	//A cell as wide as the typical entity keeps most entities in eight cells or fewer
+	float median = m_lHalfWidth[entityCount / 2];
+	if(median > 0.0f)
+	{
+		m_fCellSize = 2.0f * median;
+	}
+}
+
+//Finds or claims the slot of a cell
+uint MyHashGrid::FindSlot(int a_nX, int a_nY, int a_nZ)
+{
+	uint mask = m_lSlot.size() - 1;
+	uint index = ((uint)a_nX * 73856093u ^ (uint)a_nY * 19349663u ^ (uint)a_nZ * 83492791u) & mask;
+	while(true)
+	{
+		MyHashGridCell& cell = m_lSlot[index];
+		if(cell.m_uStamp != m_uStamp)
+		{
+			cell.m_nX = a_nX;
+			cell.m_nY = a_nY;
+			cell.m_nZ = a_nZ;
+			cell.m_uBegin = 0;
+			cell.m_uCount = 0;
+			cell.m_uStamp = m_uStamp;
+			m_lUsedSlot.push_back(index);
+			return index;
+		}
+		if(cell.m_nX == a_nX && cell.m_nY == a_nY && cell.m_nZ == a_nZ)
+		{
+			return index;
+		}
+		index = (index + 1) & mask;
+	}
+}
+
+//Gets the cell of a point
+void MyHashGrid::GetCell(vector3 a_v3Point, int& a_nX, int& a_nY, int& a_nZ)
+{
+	a_nX = (int)std::floor(a_v3Point.x / m_fCellSize);
+	a_nY = (int)std::floor(a_v3Point.y / m_fCellSize);
+	a_nZ = (int)std::floor(a_v3Point.z / m_fCellSize);
+}
+
+//Checks if the bounds of two entities overlap
+bool MyHashGrid::IsOverlapping(uint a_uFirst, uint a_uSecond)
+{
+	vector3 overlapMin = glm::max(m_lEntityMin[a_uFirst], m_lEntityMin[a_uSecond]);
+	vector3 overlapMax = glm::min(m_lEntityMax[a_uFirst], m_lEntityMax[a_uSecond]);
+	if(overlapMin.x > overlapMax.x || overlapMin.y > overlapMax.y || overlapMin.z > overlapMax.z)
+	{
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "MyBroadPhase.h"
+
+namespace Simplex
+{
+	//Occupied cell of the hash grid, the entities of the cell are a range of the cell entity array
+	struct MyHashGridCell
+	{
+		int m_nX = 0; //cell coordinate along x
+		int m_nY = 0; //cell coordinate along y
+		int m_nZ = 0; //cell coordinate along z
+		uint m_uBegin = 0; //first index of the cell in the cell entity array
+		uint m_uCount = 0; //entities in the cell
+		uint m_uStamp = 0; //update that filled the slot, slots with an older stamp are empty
+	};
+
+	//Uniform grid stored as a hash table of the occupied cells, with open addressing in one flat
+	//array; works best when the entities are about the size of a cell, as the cubes of A05 are
+	class MyHashGrid : public MyBroadPhase
+	{
+	public:
+		static const uint MAX_ENTITY_CELLS = 64; //entities reaching more cells are tested against every entity instead
+
+	private:
+		MeshManager* m_pMeshMngr = nullptr; //mesh manager singleton
+		MyEntityManager* m_pEntityMngr = nullptr; //entity manager singleton
+
+		float m_fCellSize = 1.0f; //size of a cell
+		bool m_bAutoCellSize = true; //derive the cell size from the median half width of the entities
+		uint m_uStamp = 0; //current update, marks the slots filled by it
+
+		std::vector<MyHashGridCell> m_lSlot; //hash table of the occupied cells, the size is a power of two
+		std::vector<uint> m_lUsedSlot; //slots filled by the current update
+		std::vector<uint> m_lCellEntity; //entities of every cell, grouped by cell
+		std::vector<uint> m_lOversize; //entities reaching more than MAX_ENTITY_CELLS cells
+		std::vector<vector3> m_lEntityMin; //minimum of each entity's proxy box at the last update
+		std::vector<vector3> m_lEntityMax; //maximum of each entity's proxy box at the last update
+		std::vector<float> m_lHalfWidth; //half widths of the entities while the median is found
+
+	public:
+		/*
+		USAGE: Constructor, buckets every entity the entity manager holds
+		ARGUMENTS:
+		- float a_fCellSize = 0.0f -> size of a cell, 0 derives it from the median half width of the entities
+		OUTPUT: class object
+		*/
+		MyHashGrid(float a_fCellSize = 0.0f);
+		/*
+		USAGE: Copy constructor
+		ARGUMENTS: class object to copy
+		OUTPUT: class object instance
+		*/
+		MyHashGrid(MyHashGrid const& other);
+		/*
+		USAGE: Copy assignment operator
+		ARGUMENTS: class object to copy
+		OUTPUT: ---
+		*/
+		MyHashGrid& operator=(MyHashGrid const& other);
+		/*
+		USAGE: Destructor
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		~MyHashGrid();
+		/*
+		USAGE: Changes object contents for other object's
+		ARGUMENTS:
+		- MyHashGrid& other -> object to swap content from
+		OUTPUT: ---
+		*/
+		void Swap(MyHashGrid& other);
+		/*
+		USAGE: Buckets every entity again by the cells its bounds reach, the arrays are reused so a frame
+		does not allocate once they are big enough
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		virtual void UpdateEntities() override;
+		/*
+		USAGE: Lists each pair of entities whose proxy boxes overlap exactly once, a pair is reported by
+		the cell holding the minimum corner of the overlap of the two bounds
+		ARGUMENTS:
+		- std::vector<std::pair<uint, uint>>& a_lPair -> output, pairs of entity indices (lower index first)
+		OUTPUT: ---
+		*/
+		virtual void GetCandidatePairs(std::vector<std::pair<uint, uint>>& a_lPair) override;
+		/*
+		USAGE: Displays the occupied cells in the color specified
+		ARGUMENTS:
+		- vector3 a_v3Color = C_YELLOW -> color of the volumes to display
+		OUTPUT: ---
+		*/
+		virtual void Display(vector3 a_v3Color = C_YELLOW) override;
+		/*
+		USAGE: Gets the memory the grid holds on to, the capacity of its arrays included
+		ARGUMENTS: ---
+		OUTPUT: bytes
+		*/
+		virtual size_t GetMemoryUsage() override;
+		/*
+		USAGE: Sets the size of the cells and buckets the entities again
+		ARGUMENTS:
+		- float a_fCellSize -> size of a cell, 0 derives it from the median half width of the entities
+		OUTPUT: ---
+		*/
+		void SetCellSize(float a_fCellSize);
+		/*
+		USAGE: Gets the size of the cells
+		ARGUMENTS: ---
+		OUTPUT: cell size
+		*/
+		float GetCellSize();
+		/*
+		USAGE: Gets the number of occupied cells
+		ARGUMENTS: ---
+		OUTPUT: cell count
+		*/
+		uint GetCellCount();
+		/*
+		USAGE: Gets the number of entities too big for the grid
+		ARGUMENTS: ---
+		OUTPUT: entities reaching more than MAX_ENTITY_CELLS cells
+		*/
+		uint GetOversizeCount();
+
+	private:
+		/*
+		USAGE: Deallocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Release();
+		/*
+		USAGE: Allocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Init();
+		/*
+		USAGE: Sets the cell size to twice the median half width of the entities
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void FitCellSize();
+		/*
+		USAGE: Finds the slot of a cell, claiming an empty slot for it if the cell is not in the table
+		ARGUMENTS:
+		- int a_nX -> cell coordinate along x
+		- int a_nY -> cell coordinate along y
+		- int a_nZ -> cell coordinate along z
+		OUTPUT: index of the slot
+		*/
+		uint FindSlot(int a_nX, int a_nY, int a_nZ);
+		/*
+		USAGE: Gets the cell holding a point
+		ARGUMENTS:
+		- vector3 a_v3Point -> point in global space
+		- int& a_nX -> output, cell coordinate along x
+		- int& a_nY -> output, cell coordinate along y
+		- int& a_nZ -> output, cell coordinate along z
+		OUTPUT: ---
+		*/
+		void GetCell(vector3 a_v3Point, int& a_nX, int& a_nY, int& a_nZ);
+		/*
+		USAGE: Asks if the bounds of two entities overlap
+		ARGUMENTS:
+		- uint a_uFirst -> index of the first entity
+		- uint a_uSecond -> index of the second entity
+		OUTPUT: overlap
+		*/
+		bool IsOverlapping(uint a_uFirst, uint a_uSecond);
+	};
+}
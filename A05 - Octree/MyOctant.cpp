@@ -1,80 +1,305 @@
 #include "MyOctant.h"
+#include "MyWorkerPool.h"
+#include <fstream>
+#include <functional>
+#include <limits>
 using namespace Simplex;
 
-uint MyOctant::m_uOctantCount = 0;
-uint MyOctant::m_uMaxLevel = 3;
-uint MyOctant::m_uIdealEntityCount = 5;
+template<uint Dimension, uint Depth>
+const uint MySpatialTree<Dimension, Depth>::DIMENSION;
+template<uint Dimension, uint Depth>
+const uint MySpatialTree<Dimension, Depth>::CHILD_COUNT;
+template<uint Dimension, uint Depth>
+const uint MySpatialTree<Dimension, Depth>::FULL_CHILD_MASK;
+template<uint Dimension, uint Depth>
+const uint MySpatialTree<Dimension, Depth>::MAX_LEVEL;
+template<uint Dimension, uint Depth>
+const uint MySpatialTree<Dimension, Depth>::PARALLEL_LEVEL;
+template<uint Dimension, uint Depth>
+const uint MySpatialTree<Dimension, Depth>::INVALID_NODE;
 
 //Gets the octant count
-uint MyOctant::GetOctantCount()
+template<uint Dimension, uint Depth>
+uint MySpatialTree<Dimension, Depth>::GetOctantCount()
 {
-	return m_uOctantCount;
+	uint count = m_lNode.size();
+	for(uint i = 0; i < CHILD_COUNT; i++)
+	{
+		count -= m_lFreeBlock[i].size() * (i + 1);
+	}
+	return count;
+}
+
+//Gets the list of non empty leafs
+template<uint Dimension, uint Depth>
+std::vector<uint> const& MySpatialTree<Dimension, Depth>::GetLeafList()
+{
+	return m_lChild;
+}
+
+//Counts the nodes and entities of the tree
+template<uint Dimension, uint Depth>
+MyOctantStats const& MySpatialTree<Dimension, Depth>::GetStats()
+{
+	m_Stats.m_lLevelNodeCount.assign(m_uMaxLevel + 1, 0);
+	m_Stats.m_lLevelLeafCount.assign(m_uMaxLevel + 1, 0);
+	for(uint i = 0; i < 8; i++)
+	{
+		m_Stats.m_uOccupancy[i] = 0;
+	}
+	m_Stats.m_uEntryCount = 0;
+	m_Stats.m_uStraddlerCount = 0;
+	m_lStatCount.assign(m_lEntityMin.size(), 0);
+	uint nodeCount = m_lNode.size();
+	for(uint i = 0; i < nodeCount; i++)
+	{
+		MyOctantNode const& node = m_lNode[i];
+		if(node.m_uKey == 0)
+		{
+			continue;
+		}
+		uint entityCount = node.m_uEntityCount;
+		m_Stats.m_lLevelNodeCount[node.m_uLevel]++;
+		m_Stats.m_uEntryCount += entityCount;
+		if(!IsLeaf(i))
+		{
+			//Only a loose tree keeps entities in a node with children
+			m_Stats.m_uStraddlerCount += entityCount;
+			continue;
+		}
+		m_Stats.m_lLevelLeafCount[node.m_uLevel]++;
+		//Buckets grow by powers of two past 2 entities
+		uint bucket = 0;
+		while(bucket < 7 && entityCount > (bucket < 3 ? bucket : 1u << (bucket - 1)))
+		{
+			bucket++;
+		}
+		m_Stats.m_uOccupancy[bucket]++;
+		uint const* entityList = GetEntityList(i);
+		for(uint j = 0; j < entityCount; j++)
+		{
+			if(++m_lStatCount[entityList[j]] == 2)
+			{
+				m_Stats.m_uStraddlerCount++;
+			}
+		}
+	}
+	return m_Stats;
+}
+
+//Measures the time since a point in time
+template<uint Dimension, uint Depth>
+float MySpatialTree<Dimension, Depth>::GetMillisecondsSince(std::chrono::high_resolution_clock::time_point a_Start)
+{
+	std::chrono::duration<float, std::milli> elapsed = std::chrono::high_resolution_clock::now() - a_Start;
+	return elapsed.count();
+}
+
+//Gets the maximum level
+template<uint Dimension, uint Depth>
+uint MySpatialTree<Dimension, Depth>::GetMaxLevel()
+{
+	return m_uMaxLevel;
+}
+
+//Gets the ideal entity count
+template<uint Dimension, uint Depth>
+uint MySpatialTree<Dimension, Depth>::GetIdealEntityCount()
+{
+	return m_uIdealEntityCount;
+}
+
+//Gets the flags
+template<uint Dimension, uint Depth>
+uint MySpatialTree<Dimension, Depth>::GetFlags()
+{
+	return m_uFlags;
+}
+
+//Gets the parent of a node
+template<uint Dimension, uint Depth>
+uint MySpatialTree<Dimension, Depth>::GetParent(uint a_uNode)
+{
+	if(a_uNode == 0 || a_uNode >= m_lNode.size())
+	{
+		return INVALID_NODE;
+	}
+	return m_lNode[a_uNode].m_uParent;
 }
 
-//Gets the parent of the octant
-MyOctant* MyOctant::GetParent()
+//Gets the size of the root octant
+template<uint Dimension, uint Depth>
+float MySpatialTree<Dimension, Depth>::GetSize()
 {
-	return m_pParent;
+	return m_lNode[0].m_fSize;
 }
 
-//Gets the size of the ocant
-float MyOctant::GetSize()
+//Gets the center global vector3 of the root octant
+template<uint Dimension, uint Depth>
+vector3 MySpatialTree<Dimension, Depth>::GetCenterGlobal()
 {
-	return m_fSize;
+	return m_lNode[0].m_v3Center;
 }
 
-//Gets the center global vector3
-vector3 MyOctant::GetCenterGlobal()
+//Gets the min global vector3 of the root octant
+template<uint Dimension, uint Depth>
+vector3 MySpatialTree<Dimension, Depth>::GetMinGlobal()
 {
-	return m_v3Center;
+	return m_lNode[0].m_v3Min;
 }
 
-//Gets the min global vector3
-vector3 MyOctant::GetMinGlobal()
+//Gets the max global vector3 of the root octant
+template<uint Dimension, uint Depth>
+vector3 MySpatialTree<Dimension, Depth>::GetMaxGlobal()
 {
-	return m_v3Min;
+	return m_lNode[0].m_v3Max;
 }
 
-//Gets the max global vector3
-vector3 MyOctant::GetMaxGlobal()
+//Gets the node at a given index
+template<uint Dimension, uint Depth>
+MyOctantNode const* MySpatialTree<Dimension, Depth>::GetNode(uint a_uNode)
 {
-	return m_v3Max;
+	if(a_uNode >= m_lNode.size())
+	{
+		return nullptr;
+	}
+	return &m_lNode[a_uNode];
 }
 
-//Gets the child octant at a given index
-MyOctant* MyOctant::GetChild(uint a_nChild)
+//Gets the entities of a node
+template<uint Dimension, uint Depth>
+uint const* MySpatialTree<Dimension, Depth>::GetEntityList(uint a_uNode)
 {
-	if (a_nChild > 7)
+	if(a_uNode >= m_lNode.size())
 	{
 		return nullptr;
 	}
-	return m_pChild[a_nChild];
+	return m_lEntity.data() + m_lNode[a_uNode].m_uEntityBegin;
+}
+
+//Gets the child of a node at a given morton index
+template<uint Dimension, uint Depth>
+uint MySpatialTree<Dimension, Depth>::GetChild(uint a_uNode, uint a_nChild)
+{
+	if(a_nChild >= CHILD_COUNT || IsLeaf(a_uNode))
+	{
+		return INVALID_NODE;
+	}
+	uint childMask = m_lNode[a_uNode].m_uChildMask;
+	if(!(childMask & (1 << a_nChild)))
+	{
+		return INVALID_NODE;
+	}
+	//Siblings are stored together in morton order so the child is an offset from the first one
+	return m_lNode[a_uNode].m_uFirstChild + GetChildOffset(childMask, a_nChild);
+}
+
+//Finds the node with the given locational code
+template<uint Dimension, uint Depth>
+uint MySpatialTree<Dimension, Depth>::GetNodeIndex(uint a_uKey)
+{
+	if(a_uKey == 0)
+	{
+		return INVALID_NODE;
+	}
+	//Find the level of the key from the position of its sentinel bit
+	uint level = 0;
+	while((a_uKey >> (level * Dimension)) >= CHILD_COUNT)
+	{
+		level++;
+	}
+	//Descend from the root following Dimension bits of the key per level
+	uint node = 0;
+	for(int i = level; i > 0; i--)
+	{
+		node = GetChild(node, (a_uKey >> ((i - 1) * Dimension)) & (CHILD_COUNT - 1));
+		if(node == INVALID_NODE)
+		{
+			return INVALID_NODE;
+		}
+	}
+	return node;
 }
 
 //Constructor for the octant using a max level and ideal entity count
-MyOctant::MyOctant(uint a_nMaxLevel, uint a_nIdealEntityCount)
+template<uint Dimension, uint Depth>
+MySpatialTree<Dimension, Depth>::MySpatialTree(uint a_nMaxLevel, uint a_nIdealEntityCount, uint a_uFlags)
 {
 	//Initializes the octant and sets up the parameters
 	Init();
-	m_uOctantCount = 0;
-	m_uMaxLevel = a_nMaxLevel;
 	m_uIdealEntityCount = a_nIdealEntityCount;
-	m_uID = m_uOctantCount;
-	m_pRoot = this;
-	m_lChild.clear();
-	//Makes a rigid body using the bounding points of the entities
-	std::vector<vector3> boundingPoints;
-	int entityCount = m_pEntityMngr->GetEntityCount();
+	m_uFlags = a_uFlags;
+	m_uMaxLevel = std::min(a_nMaxLevel, MAX_LEVEL);
+	CopyEntityBounds();
+	FitRootToEntities();
+	BuildTree();
+	AssignIDtoEntity();
+}
+
+//Constructor for the octant using a copy of the entity bounds
+template<uint Dimension, uint Depth>
+MySpatialTree<Dimension, Depth>::MySpatialTree(std::vector<vector3> const& a_lEntityMin, std::vector<vector3> const& a_lEntityMax, uint a_nMaxLevel, uint a_nIdealEntityCount, uint a_uFlags)
+{
+	Init();
+	m_uIdealEntityCount = a_nIdealEntityCount;
+	m_uFlags = a_uFlags;
+	m_uMaxLevel = std::min(a_nMaxLevel, MAX_LEVEL);
+	m_lEntityMin = a_lEntityMin;
+	m_lEntityMax = a_lEntityMax;
+	FitRootToEntities();
+	BuildTree();
+}
+
+//Constructor for the octant using a snapshot file
+template<uint Dimension, uint Depth>
+MySpatialTree<Dimension, Depth>::MySpatialTree(String a_sFileName, uint a_nMaxLevel, uint a_nIdealEntityCount, uint a_uFlags)
+{
+	Init();
+	m_uIdealEntityCount = a_nIdealEntityCount;
+	m_uFlags = a_uFlags;
+	m_uMaxLevel = std::min(a_nMaxLevel, MAX_LEVEL);
+	if(LoadSnapshot(a_sFileName))
+	{
+		return;
+	}
+	CopyEntityBounds();
+	FitRootToEntities();
+	BuildTree();
+	AssignIDtoEntity();
+	SaveSnapshot(a_sFileName);
+}
+
+//Copies the bounds of the entities
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::CopyEntityBounds()
+{
+	m_lEntityMin = m_pEntityMngr->GetProxyMinList();
+	m_lEntityMax = m_pEntityMngr->GetProxyMaxList();
+}
+
+//Sizes the root to contain all the entities
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::FitRootToEntities()
+{
+	//Finds the bounding box of all the entities
+	vector3 minimum = vector3(0.0f);
+	vector3 maximum = vector3(0.0f);
+	int entityCount = m_lEntityMin.size();
 	for(int i = 0; i < entityCount; i++)
 	{
-		MyEntity* entity = m_pEntityMngr->GetEntity(i);
-		MyRigidBody* rigidBody = entity->GetRigidBody();
-		boundingPoints.push_back(rigidBody->GetMinGlobal());
-		boundingPoints.push_back(rigidBody->GetMaxGlobal());
+		vector3 minOther = m_lEntityMin[i];
+		vector3 maxOther = m_lEntityMax[i];
+		if(i == 0)
+		{
+			minimum = minOther;
+			maximum = maxOther;
+			continue;
+		}
+		minimum = glm::min(minimum, minOther);
+		maximum = glm::max(maximum, maxOther);
 	}
-	MyRigidBody* rigidBody = new MyRigidBody(boundingPoints);
-	//Calculates the maximum size using the rigid body
-	vector3 halfWidth = rigidBody->GetHalfWidth();
+	//Calculates the maximum size using the bounding box
+	vector3 halfWidth = (maximum - minimum) / 2.0f;
 	float maxSize = halfWidth.x;
 	if(halfWidth.y > maxSize)
 	{
@@ -84,90 +309,87 @@ MyOctant::MyOctant(uint a_nMaxLevel, uint a_nIdealEntityCount)
 	{
 		maxSize = halfWidth.z;
 	}
-	//Sets the calculated values, constructs the tree, and destroys the rigid body
-	m_v3Center = rigidBody->GetCenterGlobal();
-	m_v3Min = m_v3Center - vector3(maxSize);
-	m_v3Max = m_v3Center + vector3(maxSize);
-	m_fSize = maxSize * 2.0f;
-	m_uOctantCount++;
-	ConstructTree(m_uMaxLevel);
-	SafeDelete(rigidBody);
-}
-
-//Constructor for the octant using a center and a size
-MyOctant::MyOctant(vector3 a_v3Center, float a_fSize)
-{
-	Init();
-	m_v3Center = a_v3Center;
-	m_fSize = a_fSize;
-	m_v3Min = m_v3Center - (vector3(a_fSize) / 2);
-	m_v3Max = m_v3Center + (vector3(a_fSize) / 2);
-	m_uOctantCount++;
+	//Sets the calculated values in the root
+	MyOctantNode& root = m_lNode[0];
+	root.m_v3Center = minimum + halfWidth;
+	root.m_v3Min = root.m_v3Center - vector3(maxSize);
+	root.m_v3Max = root.m_v3Center + vector3(maxSize);
+	root.m_fSize = maxSize * 2.0f;
 }
 
 //Copy constructor for the octant
-MyOctant::MyOctant(MyOctant const& other)
-{
-	m_uChildren = other.m_uChildren;
-	m_v3Center = other.m_v3Center;
-	m_v3Min = other.m_v3Min;
-	m_v3Max = other.m_v3Max;
-	m_fSize = other.m_fSize;
-	m_uID = other.m_uID;
-	m_uLevel = other.m_uLevel;
-	m_pParent = other.m_pParent;
-	m_pRoot = other.m_pRoot;
+template<uint Dimension, uint Depth>
+MySpatialTree<Dimension, Depth>::MySpatialTree(MySpatialTree const& other)
+{
+	m_lNode = other.m_lNode;
 	m_lChild = other.m_lChild;
-	m_pMeshMngr = MeshManager::GetInstance();
-	m_pEntityMngr = MyEntityManager::GetInstance();
-	for(int i = 0; i < 8; i++)
+	for(uint i = 0; i < CHILD_COUNT; i++)
 	{
-		m_pChild[i] = other.m_pChild[i];
+		m_lFreeBlock[i] = other.m_lFreeBlock[i];
 	}
+	m_lEntity = other.m_lEntity;
+	m_uEntityGarbage = other.m_uEntityGarbage;
+	m_lEntityMin = other.m_lEntityMin;
+	m_lEntityMax = other.m_lEntityMax;
+	m_uMaxLevel = other.m_uMaxLevel;
+	m_uIdealEntityCount = other.m_uIdealEntityCount;
+	m_uFlags = other.m_uFlags;
+	m_pMeshMngr = MeshManager::GetInstance();
+	m_pEntityMngr = MyEntityManager::GetInstance();
 }
 
 //Copy assignment constructor for the octant
-MyOctant& MyOctant::operator=(MyOctant const& other)
+template<uint Dimension, uint Depth>
+MySpatialTree<Dimension, Depth>& MySpatialTree<Dimension, Depth>::operator=(MySpatialTree const& other)
 {
 	if(this != &other)
 	{
 		Release();
 		Init();
-		MyOctant octant(other);
+		MySpatialTree octant(other);
 		Swap(octant);
 	}
 	return *this;
 }
 
 //Destructor for the octant
-MyOctant::~MyOctant()
+template<uint Dimension, uint Depth>
+MySpatialTree<Dimension, Depth>::~MySpatialTree()
 {
 	Release();
 }
 
 //Swaps the values of the octant with the values of the one passed in
-void MyOctant::Swap(MyOctant& other)
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::Swap(MySpatialTree& other)
 {
-	std::swap(m_uChildren, other.m_uChildren);
-	std::swap(m_fSize, other.m_fSize);
-	std::swap(m_uID, other.m_uID);
-	std::swap(m_pRoot, other.m_pRoot);
+	std::swap(m_lNode, other.m_lNode);
 	std::swap(m_lChild, other.m_lChild);
-	std::swap(m_v3Center, other.m_v3Center);
-	std::swap(m_v3Min, other.m_v3Min);
-	std::swap(m_v3Max, other.m_v3Max);
-	m_pMeshMngr = MeshManager::GetInstance();
-	m_pEntityMngr = MyEntityManager::GetInstance();
-	std::swap(m_uLevel, other.m_uLevel);
-	std::swap(m_pParent, other.m_pParent);
-	for (int i = 0; i < 8; i++)
+	for(uint i = 0; i < CHILD_COUNT; i++)
 	{
-		std::swap(m_pChild[i], other.m_pChild[i]);
+		std::swap(m_lFreeBlock[i], other.m_lFreeBlock[i]);
 	}
+	std::swap(m_lEntity, other.m_lEntity);
+	std::swap(m_uEntityGarbage, other.m_uEntityGarbage);
+	std::swap(m_lEntityMin, other.m_lEntityMin);
+	std::swap(m_lEntityMax, other.m_lEntityMax);
+	std::swap(m_uMaxLevel, other.m_uMaxLevel);
+	std::swap(m_uIdealEntityCount, other.m_uIdealEntityCount);
+	std::swap(m_uFlags, other.m_uFlags);
+	m_pMeshMngr = MeshManager::GetInstance();
+	m_pEntityMngr = MyEntityManager::GetInstance();
+}
+
+//Checks if the root octant is colliding with a given entity
+template<uint Dimension, uint Depth>
+bool MySpatialTree<Dimension, Depth>::IsColliding(uint a_uRBIndex)
+{
+	return IsColliding(0, a_uRBIndex);
 }
 
-//Checks if the octant is colliding with a given entity
-bool MyOctant::IsColliding(uint a_uRBIndex)
+//Checks if a node is colliding with a given entity
+template<uint Dimension, uint Depth>
+bool MySpatialTree<Dimension, Depth>::IsColliding(uint a_uNode, uint a_uRBIndex)
 {
 	//Accesses the entity
 	int entityCount = m_pEntityMngr->GetEntityCount();
@@ -175,146 +397,271 @@ bool MyOctant::IsColliding(uint a_uRBIndex)
 	{
 		return false;
 	}
-	MyEntity* entity = m_pEntityMngr->GetEntity(a_uRBIndex);
-	MyRigidBody* rigidBody = entity->GetRigidBody();
-	vector3 minOther = rigidBody->GetMinGlobal();
-	vector3 maxOther = rigidBody->GetMaxGlobal();
-	//Does AABB checks on the octant and the entity
-	if(m_v3Max.x < minOther.x)
+	return IsColliding(a_uNode, m_pEntityMngr->GetProxyMinList()[a_uRBIndex], m_pEntityMngr->GetProxyMaxList()[a_uRBIndex]);
+}
+
+//Checks if a node is colliding with a box
+template<uint Dimension, uint Depth>
+bool MySpatialTree<Dimension, Depth>::IsColliding(uint a_uNode, vector3 a_v3Min, vector3 a_v3Max)
+{
+	if(a_uNode >= m_lNode.size())
+	{
+		return false;
+	}
+	MyOctantNode& node = m_lNode[a_uNode];
+	//Does AABB checks on the node and the box
+	if(node.m_v3Max.x < a_v3Min.x)
+	{
+		return false;
+	}
+	if(node.m_v3Min.x > a_v3Max.x)
 	{
 		return false;
 	}
-	if(m_v3Min.x > maxOther.x)
+	if(node.m_v3Max.y < a_v3Min.y)
 	{
 		return false;
 	}
-	if(m_v3Max.y < minOther.y)
+	if(node.m_v3Min.y > a_v3Max.y)
 	{
 		return false;
 	}
-	if(m_v3Min.y > maxOther.y)
+	if(node.m_v3Max.z < a_v3Min.z)
 	{
 		return false;
 	}
-	if(m_v3Max.z < minOther.z)
+	if(node.m_v3Min.z > a_v3Max.z)
 	{
 		return false;
 	}
-	if(m_v3Min.z > maxOther.z)
+	return true;
+}
+
+//Checks if a box overlaps the loose bounds of a node
+template<uint Dimension, uint Depth>
+bool MySpatialTree<Dimension, Depth>::IsCollidingLoose(uint a_uNode, vector3 a_v3Min, vector3 a_v3Max)
+{
+	if(a_uNode >= m_lNode.size())
 	{
 		return false;
 	}
+	vector3 looseMin;
+	vector3 looseMax;
+	GetLooseBounds(m_lNode[a_uNode], looseMin, looseMax);
+	for(uint axis = 0; axis < 3; axis++)
+	{
+		if(looseMax[axis] < a_v3Min[axis] || looseMin[axis] > a_v3Max[axis])
+		{
+			return false;
+		}
+	}
 	return true;
 }
 
-//Displays the octant with the given index and any children
-void MyOctant::Display(uint a_nIndex, vector3 a_v3Color)
+//Gets the loose bounds of a node
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::GetLooseBounds(MyOctantNode const& a_Node, vector3& a_v3Min, vector3& a_v3Max)
+{
+	//Half the size of the loose bounds is the size of the node, the axis a quadtree keeps whole is not loosened
+	a_v3Min = a_Node.m_v3Center - vector3(a_Node.m_fSize);
+	a_v3Max = a_Node.m_v3Center + vector3(a_Node.m_fSize);
+	if(Dimension == 2)
+	{
+		a_v3Min.y = a_Node.m_v3Min.y;
+		a_v3Max.y = a_Node.m_v3Max.y;
+	}
+}
+
+//Displays the octant with the given index
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::Display(uint a_nIndex, vector3 a_v3Color)
 {
-	if(m_uID == a_nIndex)
+	if(a_nIndex >= m_lNode.size())
+	{
+		return;
+	}
+	//Nodes released by a collapse have no key
+	MyOctantNode& node = m_lNode[a_nIndex];
+	if(node.m_uKey == 0)
 	{
-		m_pMeshMngr->AddWireCubeToRenderList(glm::translate(IDENTITY_M4, m_v3Center) * glm::scale(vector3(m_fSize)), a_v3Color, RENDER_WIRE);
 		return;
 	}
-	for(int i = 0; i < m_uChildren; i++)
+	m_pMeshMngr->AddWireCubeToRenderList(glm::translate(IDENTITY_M4, node.m_v3Center) * glm::scale(node.m_v3Max - node.m_v3Min), a_v3Color, RENDER_WIRE);
+}
+
+//Displays every octant in the tree
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::Display(vector3 a_v3Color)
+{
+	int nodeCount = m_lNode.size();
+	for(int i = 0; i < nodeCount; i++)
 	{
-		m_pChild[i]->Display(a_nIndex);
+		Display(i, a_v3Color);
 	}
 }
 
-//Displays the octant and any children
-void MyOctant::Display(vector3 a_v3Color)
+//Gets the memory the tree holds
+template<uint Dimension, uint Depth>
+size_t MySpatialTree<Dimension, Depth>::GetMemoryUsage()
 {
-	for(int i = 0; i < m_uChildren; i++)
+	size_t memory = sizeof(MySpatialTree);
+	memory += m_lNode.capacity() * sizeof(MyOctantNode);
+	memory += (m_lEntity.capacity() + m_lMerge.capacity()) * sizeof(uint);
+	memory += m_lChild.capacity() * sizeof(uint);
+	for(uint i = 0; i < CHILD_COUNT; i++)
 	{
-		m_pChild[i]->Display(a_v3Color);
+		memory += m_lFreeBlock[i].capacity() * sizeof(uint);
 	}
-	m_pMeshMngr->AddWireCubeToRenderList(glm::translate(IDENTITY_M4, m_v3Center) * glm::scale(vector3(m_fSize)), a_v3Color, RENDER_WIRE);
+	memory += (m_lEntityMin.capacity() + m_lEntityMax.capacity()) * sizeof(vector3);
+	memory += (m_lMoved.capacity() + m_lOldLeaf.capacity() + m_lNewLeaf.capacity() + m_lGrown.capacity() + m_lShrunk.capacity()) * sizeof(uint);
+	memory += (m_lQueryMark.capacity() + m_lStatCount.capacity()) * sizeof(uint);
+	memory += (m_lQueryNode.capacity() + m_lQueryHit.capacity()) * sizeof(std::pair<float, uint>);
+	return memory;
 }
 
-//Displays the leafs of the octant
-void MyOctant::DisplayLeafs(vector3 a_v3Color)
+//Displays the root and the non empty leafs
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::DisplayLeafs(vector3 a_v3Color)
 {
 	int leafCount = m_lChild.size();
 	for(int i = 0; i < leafCount; i++)
 	{
-		m_lChild[i]->DisplayLeafs(a_v3Color);
+		Display(m_lChild[i], a_v3Color);
 	}
-	m_pMeshMngr->AddWireCubeToRenderList(glm::translate(IDENTITY_M4, m_v3Center) * glm::scale(vector3(m_fSize)), a_v3Color, RENDER_WIRE);
+	Display(0, a_v3Color);
 }
 
-//Clears the entity list
-void MyOctant::ClearEntityList()
+//Clears the entity list of every node
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::ClearEntityList()
 {
-	for(int i = 0; i < m_uChildren; i++)
+	int nodeCount = m_lNode.size();
+	for(int i = 0; i < nodeCount; i++)
 	{
-		m_pChild[i]->ClearEntityList();
+		m_lNode[i].m_uEntityBegin = 0;
+		m_lNode[i].m_uEntityCount = 0;
+		m_lNode[i].m_uEntityCapacity = 0;
 	}
-	m_EntityList.clear();
+	m_lEntity.clear();
+	m_uEntityGarbage = 0;
 }
 
-//Subdivides the octant
-void MyOctant::Subdivide()
+//Subdivides a node
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::Subdivide(uint a_uNode)
 {
+	//Ignore if the node does not exist
+	if(a_uNode >= m_lNode.size())
+	{
+		return;
+	}
 	//Ignore if it has reached the max levels
-	if(m_uLevel >= m_uMaxLevel)
+	if(m_lNode[a_uNode].m_uLevel >= m_uMaxLevel)
 	{
 		return;
 	}
 	//Ignore if it already has children
-	if(m_uChildren != 0)
+	if(!IsLeaf(a_uNode))
 	{
 		return;
 	}
-	//Set the children count and its size
-	m_uChildren = 8;
-	float size = m_fSize / 4.0f;
+	uint firstChild = AllocateBlock(CHILD_COUNT);
+	m_lNode[a_uNode].m_uFirstChild = firstChild;
+	m_lNode[a_uNode].m_uChildMask = FULL_CHILD_MASK;
+	MakeChildren(m_lNode[a_uNode], a_uNode, &m_lNode[firstChild]);
+}
+
+//Gets a block of nodes
+template<uint Dimension, uint Depth>
+uint MySpatialTree<Dimension, Depth>::AllocateBlock(uint a_uCount)
+{
+	//Reuses a block of the same size released by a collapse if there is one
+	std::vector<uint>& lFreeBlock = m_lFreeBlock[a_uCount - 1];
+	if(lFreeBlock.size() > 0)
+	{
+		uint first = lFreeBlock.back();
+		lFreeBlock.pop_back();
+		return first;
+	}
+	uint first = m_lNode.size();
+	m_lNode.resize(first + a_uCount);
+	return first;
+}
+
+//Releases a block of nodes
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::ReleaseBlock(uint a_uFirst, uint a_uCount)
+{
+	for(uint i = 0; i < a_uCount; i++)
+	{
+		ReleaseEntities(a_uFirst + i);
+		MyOctantNode& node = m_lNode[a_uFirst + i];
+		node.m_uKey = 0;
+		node.m_uFirstChild = 0;
+		node.m_uChildMask = 0;
+	}
+	m_lFreeBlock[a_uCount - 1].push_back(a_uFirst);
+}
+
+//Creates the children of a node next to each other in morton order
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::MakeChildren(MyOctantNode const& a_Parent, uint a_uParent, MyOctantNode* a_pChild)
+{
+	float size = a_Parent.m_fSize / 4.0f;
 	float doubleSize = size * 2.0f;
-	//Create each child octant
-	vector3 center;
-	center = m_v3Center + vector3(size, size, size);
-	m_pChild[0] = new MyOctant(center, doubleSize);
-	center = m_v3Center + vector3(size, size, -size);
-	m_pChild[1] = new MyOctant(center, doubleSize);
-	center = m_v3Center + vector3(size, -size, size);
-	m_pChild[2] = new MyOctant(center, doubleSize);
-	center = m_v3Center + vector3(size, -size, -size);
-	m_pChild[3] = new MyOctant(center, doubleSize);
-	center = m_v3Center + vector3(-size, size, size);
-	m_pChild[4] = new MyOctant(center, doubleSize);
-	center = m_v3Center + vector3(-size, size, -size);
-	m_pChild[5] = new MyOctant(center, doubleSize);
-	center = m_v3Center + vector3(-size, -size, size);
-	m_pChild[6] = new MyOctant(center, doubleSize);
-	center = m_v3Center + vector3(-size, -size, -size);
-	m_pChild[7] = new MyOctant(center, doubleSize);
-	//Set the root, parent, and level of each child octant
-	for(int i = 0; i < 8; i++)
+	uint count = 0;
+	for(uint i = 0; i < CHILD_COUNT; i++)
 	{
-		m_pChild[i]->m_pRoot = m_pRoot;
-		m_pChild[i]->m_pParent = this;
-		m_pChild[i]->m_uLevel = m_uLevel + 1;
-		//Subdivide the child again if it hase more than the ideal entity count
-		if(m_pChild[i]->ContainsMoreThan(m_uIdealEntityCount))
+		if(!(a_Parent.m_uChildMask & (1 << i)))
+		{
+			continue;
+		}
+		MyOctantNode& child = a_pChild[count++];
+		child.m_uKey = (a_Parent.m_uKey << Dimension) | i;
+		child.m_uLevel = a_Parent.m_uLevel + 1;
+		child.m_uParent = a_uParent;
+		child.m_uFirstChild = 0;
+		child.m_uChildMask = 0;
+		child.m_fSize = doubleSize;
+		//An axis that is not split keeps the bounds of the parent
+		child.m_v3Center = a_Parent.m_v3Center;
+		child.m_v3Min = a_Parent.m_v3Min;
+		child.m_v3Max = a_Parent.m_v3Max;
+		//The children meet at the center of the parent so the planes match the ones GetChildMask uses
+		for(uint bit = 0; bit < Dimension; bit++)
 		{
-			m_pChild[i]->Subdivide();
+			uint axis = GetChildAxis(bit);
+			bool upper = (i >> bit) & 1;
+			child.m_v3Center[axis] += upper ? size : -size;
+			child.m_v3Min[axis] = upper ? a_Parent.m_v3Center[axis] : a_Parent.m_v3Min[axis];
+			child.m_v3Max[axis] = upper ? a_Parent.m_v3Max[axis] : a_Parent.m_v3Center[axis];
 		}
+		child.m_uEntityBegin = 0;
+		child.m_uEntityCount = 0;
+		child.m_uEntityCapacity = 0;
 	}
 }
 
-//Check if the octant is a leaf
-bool MyOctant::IsLeaf()
+//Check if a node is a leaf
+template<uint Dimension, uint Depth>
+bool MySpatialTree<Dimension, Depth>::IsLeaf(uint a_uNode)
 {
-	return m_uChildren == 0;
+	if(a_uNode >= m_lNode.size())
+	{
+		return false;
+	}
+	return m_lNode[a_uNode].m_uFirstChild == 0;
 }
 
-//Check if the octant contains more than a given number of entities
-bool MyOctant::ContainsMoreThan(uint a_nEntities)
+//Check if a node contains more than a given number of entities
+template<uint Dimension, uint Depth>
+bool MySpatialTree<Dimension, Depth>::ContainsMoreThan(uint a_uNode, uint a_nEntities)
 {
 	int entityCount = m_pEntityMngr->GetEntityCount();
 	int count = 0;
 	for(int i = 0; i < entityCount; i++)
 	{
-		if(IsColliding(i))
+		if(IsColliding(a_uNode, i))
 		{
 			count++;
 		}
@@ -326,102 +673,1747 @@ bool MyOctant::ContainsMoreThan(uint a_nEntities)
 	return false;
 }
 
-//Recursively kills the children and any sub-children
-void MyOctant::KillBranches()
+//Removes every node but the root
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::KillBranches()
 {
-	for(int i = 0; i < m_uChildren; i++)
+	int nodeCount = m_lNode.size();
+	for(int i = 1; i < nodeCount; i++)
+	{
+		ReleaseEntities(i);
+	}
+	m_lNode.resize(1);
+	m_lNode[0].m_uFirstChild = 0;
+	m_lNode[0].m_uChildMask = 0;
+	for(uint i = 0; i < CHILD_COUNT; i++)
 	{
-		m_pChild[i]->KillBranches();
-		delete m_pChild[i];
-		m_pChild[i] = nullptr;
+		m_lFreeBlock[i].clear();
 	}
-	m_uChildren = 0;
 }
 
 //Creates the octant tree
-void MyOctant::ConstructTree(uint a_nMaxLevel)
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::ConstructTree(uint a_nMaxLevel)
 {
-	//Ignore if the level is not zero
-	if(m_uLevel != 0)
-	{
-		return;
-	}
-	m_uMaxLevel = a_nMaxLevel;
-	m_uOctantCount = 1;
+	m_uMaxLevel = std::min(a_nMaxLevel, MAX_LEVEL);
+	//Copies the bounds of the entities once so the build does not go back to the entity manager
+	CopyEntityBounds();
+	BuildTree();
+	AssignIDtoEntity();
+}
+
+//Builds the tree from the copy of the entity bounds
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::BuildTree()
+{
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
 	ClearEntityList();
 	KillBranches();
 	m_lChild.clear();
-	if(ContainsMoreThan(m_uIdealEntityCount))
+	MyOctantBranch tree;
+	uint entityCount = m_lEntityMin.size();
+	for(uint i = 0; i < entityCount; i++)
+	{
+		if(IsColliding(0, m_lEntityMin[i], m_lEntityMax[i]))
+		{
+			tree.m_lIndex.push_back(i);
+		}
+	}
+	tree.m_lNode.push_back(m_lNode[0]);
+	tree.m_lBegin.push_back(0);
+	tree.m_lCount.push_back(tree.m_lIndex.size());
+	//A parallel build stops at PARALLEL_LEVEL and leaves the deeper branches to the workers
+	uint stopLevel = m_uMaxLevel;
+	if((m_uFlags & OCTANT_PARALLEL) && stopLevel > PARALLEL_LEVEL)
 	{
-		Subdivide();
+		stopLevel = PARALLEL_LEVEL;
+	}
+	std::vector<uint> lPending;
+	BuildBranch(tree, stopLevel, &lPending);
+	m_lNode.swap(tree.m_lNode);
+	if(lPending.size() > 0)
+	{
+		BuildBranchesInParallel(tree, lPending);
 	}
-	AssignIDtoEntity();
 	ConstructList();
+	//The nodes point in to the partitioned index array, which still holds the ranges of every node that was split
+	CompactEntities(tree.m_lIndex);
+	m_Stats.m_fBuildTime = GetMillisecondsSince(start);
 }
 
-//Assign IDs to all the entities
-void MyOctant::AssignIDtoEntity()
+//Builds a branch of the tree
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::BuildBranch(MyOctantBranch& a_Branch, uint a_uStopLevel, std::vector<uint>* a_pPending)
 {
-	for(int i = 0; i < m_uChildren; i++)
+	//Children are appended behind the nodes being visited, so walking the array
+	//in order visits the branch breadth first without recursion
+	for(uint i = 0; i < a_Branch.m_lNode.size(); i++)
 	{
-		m_pChild[i]->AssignIDtoEntity();
+		uint level = a_Branch.m_lNode[i].m_uLevel;
+		if(level < m_uMaxLevel && a_Branch.m_lCount[i] > GetSplitCount())
+		{
+			if(level >= a_uStopLevel && a_pPending != nullptr)
+			{
+				a_pPending->push_back(i);
+				continue;
+			}
+			if(PartitionEntities(a_Branch, i))
+			{
+				uint firstChild = a_Branch.m_lNode.size();
+				a_Branch.m_lNode[i].m_uFirstChild = firstChild;
+				//The offset past the last child is the number of children
+				a_Branch.m_lNode.resize(firstChild + GetChildOffset(a_Branch.m_lNode[i].m_uChildMask, CHILD_COUNT));
+				MakeChildren(a_Branch.m_lNode[i], i, &a_Branch.m_lNode[firstChild]);
+				continue;
+			}
+		}
+		a_Branch.m_lNode[i].m_uEntityBegin = a_Branch.m_lBegin[i];
+		a_Branch.m_lNode[i].m_uEntityCount = a_Branch.m_lCount[i];
+		a_Branch.m_lNode[i].m_uEntityCapacity = a_Branch.m_lCount[i];
 	}
-	if(m_uChildren == 0)
+}
+
+//Builds the pending branches on the worker pool
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::BuildBranchesInParallel(MyOctantBranch& a_Top, std::vector<uint> const& a_lPending)
+{
+	//Every pending node becomes the root of its own branch with a copy of its entity range
+	uint branchCount = a_lPending.size();
+	std::vector<MyOctantBranch> lBranch(branchCount);
+	for(uint i = 0; i < branchCount; i++)
 	{
-		int entityCount = m_pEntityMngr->GetEntityCount();
-		for(int i = 0; i < entityCount; i++)
+		uint node = a_lPending[i];
+		std::vector<uint>::iterator begin = a_Top.m_lIndex.begin() + a_Top.m_lBegin[node];
+		lBranch[i].m_lNode.push_back(m_lNode[node]);
+		lBranch[i].m_lIndex.assign(begin, begin + a_Top.m_lCount[node]);
+		lBranch[i].m_lBegin.push_back(0);
+		lBranch[i].m_lCount.push_back(a_Top.m_lCount[node]);
+	}
+	//The threads of the pool take the next branch nobody has taken until there are none left, the
+	//branches only read the entity bounds and write their own arrays
+	MyWorkerPool::GetInstance()->Run(branchCount, [&](uint i)
+	{
+		BuildBranch(lBranch[i], m_uMaxLevel);
+	});
+	//Appends the branches in the order of the pending list, node k of a branch lands at offset + k
+	for(uint i = 0; i < branchCount; i++)
+	{
+		uint node = a_lPending[i];
+		std::vector<MyOctantNode>& lNode = lBranch[i].m_lNode;
+		uint offset = m_lNode.size() - 1;
+		uint nodeCount = lNode.size();
+		//The entity ranges of the branch move to the end of the index array of the top
+		uint indexOffset = a_Top.m_lIndex.size();
+		a_Top.m_lIndex.insert(a_Top.m_lIndex.end(), lBranch[i].m_lIndex.begin(), lBranch[i].m_lIndex.end());
+		for(uint k = 0; k < nodeCount; k++)
 		{
-			if(IsColliding(i))
+			lNode[k].m_uEntityBegin += indexOffset;
+			if(lNode[k].m_uFirstChild != 0)
+			{
+				lNode[k].m_uFirstChild += offset;
+			}
+			if(k > 0)
 			{
-				m_EntityList.push_back(i);
-				m_pEntityMngr->AddDimension(i, m_uID);
+				lNode[k].m_uParent = lNode[k].m_uParent == 0 ? node : lNode[k].m_uParent + offset;
 			}
 		}
+		std::swap(m_lNode[node], lNode[0]);
+		for(uint k = 1; k < nodeCount; k++)
+		{
+			m_lNode.push_back(MyOctantNode());
+			std::swap(m_lNode.back(), lNode[k]);
+		}
 	}
 }
 
-//Release the octant (used in the destructor)
-void MyOctant::Release()
+//Hands the entities of a node to its children
+template<uint Dimension, uint Depth>
+bool MySpatialTree<Dimension, Depth>::PartitionEntities(MyOctantBranch& a_Branch, uint a_uNode)
 {
-	if(m_uLevel == 0)
+	uint begin = a_Branch.m_lBegin[a_uNode];
+	uint count = a_Branch.m_lCount[a_uNode];
+	MyOctantNode& node = a_Branch.m_lNode[a_uNode];
+	std::vector<uint>& lIndex = a_Branch.m_lIndex;
+	//Finds which children each entity overlaps and counts the entities per child
+	uint childCount[CHILD_COUNT] = { 0 };
+	uint stayCount = 0;
+	a_Branch.m_lMask.resize(count);
+	for(uint i = 0; i < count; i++)
 	{
-		KillBranches();
+		uint entity = lIndex[begin + i];
+		uint mask = GetEntityChildMask(node, entity);
+		for(uint j = 0; j < CHILD_COUNT; j++)
+		{
+			childCount[j] += (mask >> j) & 1;
+		}
+		stayCount += mask == 0 ? 1 : 0;
+		a_Branch.m_lMask[i] = mask;
 	}
-	m_uChildren = 0;
-	m_fSize = 0.0f;
-	m_EntityList.clear();
-	m_lChild.clear();
+	if(!ShouldSplit(count, stayCount, childCount))
+	{
+		return false;
+	}
+	//A sparse tree leaves out the children no entity reaches
+	node.m_uChildMask = FULL_CHILD_MASK;
+	if(m_uFlags & OCTANT_SPARSE)
+	{
+		node.m_uChildMask = 0;
+		for(uint j = 0; j < CHILD_COUNT; j++)
+		{
+			if(childCount[j] > 0)
+			{
+				node.m_uChildMask |= 1 << j;
+			}
+		}
+	}
+	//Lays the ranges of the children one after the other at the end of the index array
+	uint childBegin[CHILD_COUNT];
+	uint offset = lIndex.size();
+	for(uint j = 0; j < CHILD_COUNT; j++)
+	{
+		if(!(node.m_uChildMask & (1 << j)))
+		{
+			continue;
+		}
+		childBegin[j] = offset;
+		a_Branch.m_lBegin.push_back(offset);
+		a_Branch.m_lCount.push_back(childCount[j]);
+		offset += childCount[j];
+	}
+	lIndex.resize(offset);
+	//Scatters the entities in to the ranges of their children, a loose tree keeps the ones that fit in no child
+	//at the front of the node's own range, which is never written ahead of the entity being read
+	node.m_uEntityBegin = begin;
+	node.m_uEntityCount = 0;
+	node.m_uEntityCapacity = stayCount;
+	for(uint i = 0; i < count; i++)
+	{
+		uint entity = lIndex[begin + i];
+		if(a_Branch.m_lMask[i] == 0)
+		{
+			lIndex[begin + node.m_uEntityCount++] = entity;
+		}
+		for(uint j = 0; j < CHILD_COUNT; j++)
+		{
+			if(a_Branch.m_lMask[i] & (1 << j))
+			{
+				lIndex[childBegin[j]++] = entity;
+			}
+		}
+	}
+	return true;
 }
 
-//Initialize the octant with default values
-void MyOctant::Init()
+//Decides if a node is worth splitting
+template<uint Dimension, uint Depth>
+bool MySpatialTree<Dimension, Depth>::ShouldSplit(uint a_uCount, uint a_uStayCount, uint const* a_pChildCount)
 {
-	m_uChildren = 0;
-	m_fSize = 0.0f;
-	m_uID = m_uOctantCount;
-	m_uLevel = 0;
-	m_v3Center = vector3(0.0f);
-	m_v3Min = vector3(0.0f);
-	m_v3Max = vector3(0.0f);
-	m_pMeshMngr = MeshManager::GetInstance();
-	m_pEntityMngr = MyEntityManager::GetInstance();
-	m_pRoot = nullptr;
-	m_pParent = nullptr;
-	for (int i = 0; i < 8; i++)
+	if(!(m_uFlags & OCTANT_ADAPTIVE))
+	{
+		return a_uCount > m_uIdealEntityCount;
+	}
+	//Every entity of a leaf is tested against every other one
+	float keepCost = a_uCount * (a_uCount - 1.0f) / 2.0f;
+	//After the split the entities that stay are still tested against the whole node and each child
+	//tests its own entities, which counts a straddler once per child it reaches
+	float splitCost = a_uStayCount * (a_uStayCount - 1.0f) / 2.0f + a_uStayCount * (float)(a_uCount - a_uStayCount);
+	uint childCount = 0;
+	for(uint j = 0; j < CHILD_COUNT; j++)
+	{
+		float count = a_pChildCount[j];
+		splitCost += count * (count - 1.0f) / 2.0f + count * SPLIT_ENTRY_COST;
+		childCount += a_pChildCount[j] > 0 ? 1 : 0;
+	}
+	//A sparse tree only creates the children that get entities
+	if(!(m_uFlags & OCTANT_SPARSE))
+	{
+		childCount = CHILD_COUNT;
+	}
+	splitCost += childCount * SPLIT_NODE_COST;
+	return splitCost < keepCost;
+}
+
+//Gets the count a node has to go over to be split
+template<uint Dimension, uint Depth>
+uint MySpatialTree<Dimension, Depth>::GetSplitCount()
+{
+	if(m_uFlags & OCTANT_ADAPTIVE)
+	{
+		return 1;
+	}
+	return m_uIdealEntityCount;
+}
+
+//Gets the octants of a node a box overlaps
+template<uint Dimension, uint Depth>
+uint MySpatialTree<Dimension, Depth>::GetChildMask(MyOctantNode const& a_Parent, vector3 a_v3Min, vector3 a_v3Max)
+{
+	//The lower children end and the upper children start at the center of the parent
+	vector3 center = a_Parent.m_v3Center;
+	//Drops the children on the half of each split axis the box does not reach
+	uint mask = FULL_CHILD_MASK;
+	for(uint bit = 0; bit < Dimension; bit++)
+	{
+		uint axis = GetChildAxis(bit);
+		if(a_v3Min[axis] > center[axis])
+		{
+			mask &= GetUpperChildMask(bit);
+		}
+		if(a_v3Max[axis] < center[axis])
+		{
+			mask &= ~GetUpperChildMask(bit);
+		}
+	}
+	return mask;
+}
+
+//Gets the child whose loose bounds contain a box
+template<uint Dimension, uint Depth>
+uint MySpatialTree<Dimension, Depth>::GetLooseChild(MyOctantNode const& a_Parent, vector3 a_v3Min, vector3 a_v3Max)
+{
+	//The center of the box picks the child, the loose bounds of the child reach its size away from its center
+	vector3 center = (a_v3Min + a_v3Max) / 2.0f;
+	float childSize = a_Parent.m_fSize / 2.0f;
+	uint child = 0;
+	for(uint bit = 0; bit < Dimension; bit++)
+	{
+		uint axis = GetChildAxis(bit);
+		bool upper = center[axis] > a_Parent.m_v3Center[axis];
+		float childCenter = a_Parent.m_v3Center[axis] + (upper ? childSize : -childSize) / 2.0f;
+		if(a_v3Min[axis] < childCenter - childSize || a_v3Max[axis] > childCenter + childSize)
+		{
+			return CHILD_COUNT;
+		}
+		if(upper)
+		{
+			child |= 1 << bit;
+		}
+	}
+	return child;
+}
+
+//Gets the children an entity is handed to
+template<uint Dimension, uint Depth>
+uint MySpatialTree<Dimension, Depth>::GetEntityChildMask(MyOctantNode const& a_Parent, uint a_uEntity)
+{
+	if(m_uFlags & OCTANT_LOOSE)
 	{
-		m_pChild[i] = nullptr;
+		uint child = GetLooseChild(a_Parent, m_lEntityMin[a_uEntity], m_lEntityMax[a_uEntity]);
+		return child < CHILD_COUNT ? 1 << child : 0;
 	}
+	return GetChildMask(a_Parent, m_lEntityMin[a_uEntity], m_lEntityMax[a_uEntity]);
 }
 
-//Creates the list of objects
-void MyOctant::ConstructList()
+//Finds the leafs a box overlaps
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::FindLeafs(vector3 a_v3Min, vector3 a_v3Max, std::vector<uint>& a_lLeaf)
 {
-	for(int i = 0; i < m_uChildren; i++)
+	a_lLeaf.clear();
+	if(!IsColliding(0, a_v3Min, a_v3Max))
 	{
-		m_pChild[i]->ConstructList();
+		return;
 	}
-	if (m_EntityList.size() > 0)
+	//Each level pops one node and pushes at most CHILD_COUNT, so the stack is bounded by the depth
+	uint stack[MAX_LEVEL * (CHILD_COUNT - 1) + 1];
+	uint stackSize = 0;
+	stack[stackSize++] = 0;
+	while(stackSize > 0)
 	{
-		m_pRoot->m_lChild.push_back(this);
+		uint node = stack[--stackSize];
+		if(IsLeaf(node))
+		{
+			a_lLeaf.push_back(node);
+			continue;
+		}
+		MyOctantNode const& parent = m_lNode[node];
+		uint mask = GetChildMask(parent, a_v3Min, a_v3Max) & parent.m_uChildMask;
+		for(uint j = 0; j < CHILD_COUNT; j++)
+		{
+			if(mask & (1 << j))
+			{
+				stack[stackSize++] = parent.m_uFirstChild + GetChildOffset(parent.m_uChildMask, j);
+			}
+		}
 	}
 }
+
+//Finds the node a box fits in
+template<uint Dimension, uint Depth>
+uint MySpatialTree<Dimension, Depth>::FindLooseNode(vector3 a_v3Min, vector3 a_v3Max)
+{
+	uint node = 0;
+	while(!IsLeaf(node))
+	{
+		uint child = GetLooseChild(m_lNode[node], a_v3Min, a_v3Max);
+		if(child == CHILD_COUNT)
+		{
+			break;
+		}
+		//A sparse tree may not have created the child, the box then stays in the node
+		child = GetChild(node, child);
+		if(child == INVALID_NODE)
+		{
+			break;
+		}
+		node = child;
+	}
+	return node;
+}
+
+//Finds the nodes holding an entity
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::FindEntityNodes(vector3 a_v3Min, vector3 a_v3Max, std::vector<uint>& a_lNode)
+{
+	if(m_uFlags & OCTANT_LOOSE)
+	{
+		a_lNode.clear();
+		a_lNode.push_back(FindLooseNode(a_v3Min, a_v3Max));
+		return;
+	}
+	FindLeafs(a_v3Min, a_v3Max, a_lNode);
+}
+
+//Creates the octants a box reaches in a sparse tree
+template<uint Dimension, uint Depth>
+bool MySpatialTree<Dimension, Depth>::AddMissingChildren(vector3 a_v3Min, vector3 a_v3Max)
+{
+	bool moved = false;
+	uint stack[MAX_LEVEL * (CHILD_COUNT - 1) + 1];
+	uint stackSize = 0;
+	stack[stackSize++] = 0;
+	while(stackSize > 0)
+	{
+		uint node = stack[--stackSize];
+		if(IsLeaf(node))
+		{
+			continue;
+		}
+		uint mask = GetChildMask(m_lNode[node], a_v3Min, a_v3Max);
+		if(mask & ~m_lNode[node].m_uChildMask)
+		{
+			GrowChildren(node, m_lNode[node].m_uChildMask | mask);
+			moved = true;
+		}
+		MyOctantNode const& parent = m_lNode[node];
+		for(uint j = 0; j < CHILD_COUNT; j++)
+		{
+			if(mask & (1 << j))
+			{
+				stack[stackSize++] = parent.m_uFirstChild + GetChildOffset(parent.m_uChildMask, j);
+			}
+		}
+	}
+	return moved;
+}
+
+//Moves the children of a node to a bigger block
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::GrowChildren(uint a_uNode, uint a_uChildMask)
+{
+	uint oldFirst = m_lNode[a_uNode].m_uFirstChild;
+	uint oldMask = m_lNode[a_uNode].m_uChildMask;
+	uint newFirst = AllocateBlock(GetChildOffset(a_uChildMask, CHILD_COUNT));
+	m_lNode[a_uNode].m_uFirstChild = newFirst;
+	m_lNode[a_uNode].m_uChildMask = a_uChildMask;
+	MakeChildren(m_lNode[a_uNode], a_uNode, &m_lNode[newFirst]);
+	//Swaps the children that already existed over the new ones made in their place
+	for(uint j = 0; j < CHILD_COUNT; j++)
+	{
+		if(!(oldMask & (1 << j)))
+		{
+			continue;
+		}
+		uint oldChild = oldFirst + GetChildOffset(oldMask, j);
+		uint newChild = newFirst + GetChildOffset(a_uChildMask, j);
+		std::swap(m_lNode[oldChild], m_lNode[newChild]);
+		//The grandchildren and the entities refer to the child by its index
+		MyOctantNode& child = m_lNode[newChild];
+		uint grandChildCount = GetChildOffset(child.m_uChildMask, CHILD_COUNT);
+		for(uint k = 0; k < grandChildCount; k++)
+		{
+			m_lNode[child.m_uFirstChild + k].m_uParent = newChild;
+		}
+		uint const* entityList = GetEntityList(newChild);
+		int entityCount = child.m_uEntityCount;
+		for(int k = 0; k < entityCount; k++)
+		{
+			RemoveEntityDimension(entityList[k], oldChild);
+			AddEntityDimension(entityList[k], newChild);
+		}
+	}
+	ReleaseBlock(oldFirst, GetChildOffset(oldMask, CHILD_COUNT));
+}
+
+//Finds the leaf holding a point
+template<uint Dimension, uint Depth>
+uint MySpatialTree<Dimension, Depth>::FindLeaf(vector3 a_v3Point)
+{
+	uint node = 0;
+	while(!IsLeaf(node))
+	{
+		vector3 center = m_lNode[node].m_v3Center;
+		uint child = 0;
+		for(uint bit = 0; bit < Dimension; bit++)
+		{
+			if(a_v3Point[GetChildAxis(bit)] > center[GetChildAxis(bit)])
+			{
+				child |= 1 << bit;
+			}
+		}
+		node = GetChild(node, child);
+		if(node == INVALID_NODE)
+		{
+			return INVALID_NODE;
+		}
+	}
+	return node;
+}
+
+//Checks if a point falls in a leaf
+template<uint Dimension, uint Depth>
+bool MySpatialTree<Dimension, Depth>::HoldsPoint(uint a_uLeaf, vector3 a_v3Point)
+{
+	MyOctantNode const& root = m_lNode[0];
+	MyOctantNode const& leaf = m_lNode[a_uLeaf];
+	for(uint bit = 0; bit < Dimension; bit++)
+	{
+		uint axis = GetChildAxis(bit);
+		//A point on a plane goes to the lower child, so the leaf takes its maximum but not its minimum
+		if(a_v3Point[axis] <= leaf.m_v3Min[axis] && leaf.m_v3Min[axis] != root.m_v3Min[axis])
+		{
+			return false;
+		}
+		if(a_v3Point[axis] > leaf.m_v3Max[axis] && leaf.m_v3Max[axis] != root.m_v3Max[axis])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+//Lists the pairs of entities that share a leaf
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::GetCandidatePairs(std::vector<std::pair<uint, uint>>& a_lPair)
+{
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	m_Stats.m_uTestedPairCount = 0;
+	if(m_uFlags & OCTANT_LOOSE)
+	{
+		GetLooseCandidatePairs(a_lPair);
+	}
+	else
+	{
+		GetLeafCandidatePairs(a_lPair);
+	}
+	m_Stats.m_uCandidatePairCount = a_lPair.size();
+	m_Stats.m_fPairTime = GetMillisecondsSince(start);
+}
+
+//Lists the pairs of entities that share a leaf
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::GetLeafCandidatePairs(std::vector<std::pair<uint, uint>>& a_lPair)
+{
+	a_lPair.clear();
+	int leafCount = m_lChild.size();
+	for(int i = 0; i < leafCount; i++)
+	{
+		uint leaf = m_lChild[i];
+		uint const* entityList = GetEntityList(leaf);
+		int entityCount = m_lNode[leaf].m_uEntityCount;
+		if(entityCount > 1)
+		{
+			m_Stats.m_uTestedPairCount += (unsigned long long)entityCount * (entityCount - 1) / 2;
+		}
+		for(int j = 0; j < entityCount - 1; j++)
+		{
+			uint first = entityList[j];
+			for(int k = j + 1; k < entityCount; k++)
+			{
+				uint second = entityList[k];
+				//Both bounds overlap in the box going from the max of the mins to the min of the maxes
+				vector3 overlapMin = glm::max(m_lEntityMin[first], m_lEntityMin[second]);
+				vector3 overlapMax = glm::min(m_lEntityMax[first], m_lEntityMax[second]);
+				if(overlapMin.x > overlapMax.x || overlapMin.y > overlapMax.y || overlapMin.z > overlapMax.z)
+				{
+					continue;
+				}
+				//Only one leaf holds the corner of the overlap, so only that leaf reports the pair
+				if(!HoldsPoint(leaf, overlapMin))
+				{
+					continue;
+				}
+				a_lPair.push_back(std::make_pair(std::min(first, second), std::max(first, second)));
+			}
+		}
+	}
+}
+
+//Lists the pairs of entities of a loose tree
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::GetLooseCandidatePairs(std::vector<std::pair<uint, uint>>& a_lPair)
+{
+	a_lPair.clear();
+	uint stack[MAX_LEVEL * (CHILD_COUNT - 1) + 1];
+	int nodeCount = m_lChild.size();
+	for(int i = 0; i < nodeCount; i++)
+	{
+		uint const* entityList = GetEntityList(m_lChild[i]);
+		int entityCount = m_lNode[m_lChild[i]].m_uEntityCount;
+		for(int j = 0; j < entityCount; j++)
+		{
+			uint first = entityList[j];
+			vector3 minimum = m_lEntityMin[first];
+			vector3 maximum = m_lEntityMax[first];
+			//The loose bounds of a child are inside the loose bounds of its parent, so a node the entity
+			//does not reach has no entity it could touch under it
+			uint stackSize = 0;
+			stack[stackSize++] = 0;
+			while(stackSize > 0)
+			{
+				uint node = stack[--stackSize];
+				if(!IsCollidingLoose(node, minimum, maximum))
+				{
+					continue;
+				}
+				//Each entity is in a single node so keeping the higher index lists a pair once
+				uint const* otherList = GetEntityList(node);
+				int otherCount = m_lNode[node].m_uEntityCount;
+				for(int k = 0; k < otherCount; k++)
+				{
+					uint second = otherList[k];
+					if(second <= first)
+					{
+						continue;
+					}
+					m_Stats.m_uTestedPairCount++;
+					vector3 overlapMin = glm::max(minimum, m_lEntityMin[second]);
+					vector3 overlapMax = glm::min(maximum, m_lEntityMax[second]);
+					if(overlapMin.x > overlapMax.x || overlapMin.y > overlapMax.y || overlapMin.z > overlapMax.z)
+					{
+						continue;
+					}
+					a_lPair.push_back(std::make_pair(first, second));
+				}
+				uint childCount = GetChildOffset(m_lNode[node].m_uChildMask, CHILD_COUNT);
+				for(uint k = 0; k < childCount; k++)
+				{
+					stack[stackSize++] = m_lNode[node].m_uFirstChild + k;
+				}
+			}
+		}
+	}
+}
+
+//Finds the entities overlapping a box
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::QueryBox(vector3 a_v3Min, vector3 a_v3Max, std::vector<uint>& a_lEntity)
+{
+	MyOctantQuery query;
+	query.m_uType = QUERY_BOX;
+	query.m_v3Min = a_v3Min;
+	query.m_v3Max = a_v3Max;
+	QueryVolume(query, a_lEntity);
+}
+
+//Finds the entities overlapping a sphere
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::QuerySphere(vector3 a_v3Center, float a_fRadius, std::vector<uint>& a_lEntity)
+{
+	MyOctantQuery query;
+	query.m_uType = QUERY_SPHERE;
+	query.m_v3Center = a_v3Center;
+	query.m_fRadius = a_fRadius;
+	QueryVolume(query, a_lEntity);
+}
+
+//Finds the entities inside a view frustum
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::QueryFrustum(matrix4 a_m4ViewProjection, std::vector<uint>& a_lEntity)
+{
+	//Each plane is the last row of the matrix plus or minus one of the other rows
+	MyOctantQuery query;
+	query.m_uType = QUERY_FRUSTUM;
+	vector4 last = vector4(a_m4ViewProjection[0][3], a_m4ViewProjection[1][3], a_m4ViewProjection[2][3], a_m4ViewProjection[3][3]);
+	for(uint i = 0; i < 3; i++)
+	{
+		vector4 row = vector4(a_m4ViewProjection[0][i], a_m4ViewProjection[1][i], a_m4ViewProjection[2][i], a_m4ViewProjection[3][i]);
+		query.m_v4Plane[i * 2] = last + row;
+		query.m_v4Plane[i * 2 + 1] = last - row;
+	}
+	QueryVolume(query, a_lEntity);
+}
+
+//Finds the entities overlapping a volume
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::QueryVolume(MyOctantQuery const& a_Query, std::vector<uint>& a_lEntity)
+{
+	a_lEntity.clear();
+	BeginQuery();
+	uint stack[MAX_LEVEL * (CHILD_COUNT - 1) + 1];
+	uint stackSize = 0;
+	stack[stackSize++] = 0;
+	while(stackSize > 0)
+	{
+		uint node = stack[--stackSize];
+		vector3 minimum;
+		vector3 maximum;
+		GetQueryBounds(node, minimum, maximum);
+		if(!IsTouching(a_Query, minimum, maximum))
+		{
+			continue;
+		}
+		uint const* entityList = GetEntityList(node);
+		int entityCount = m_lNode[node].m_uEntityCount;
+		for(int i = 0; i < entityCount; i++)
+		{
+			uint entity = entityList[i];
+			if(IsTouching(a_Query, m_lEntityMin[entity], m_lEntityMax[entity]) && MarkEntity(entity))
+			{
+				a_lEntity.push_back(entity);
+			}
+		}
+		uint childCount = GetChildOffset(m_lNode[node].m_uChildMask, CHILD_COUNT);
+		for(uint i = 0; i < childCount; i++)
+		{
+			stack[stackSize++] = m_lNode[node].m_uFirstChild + i;
+		}
+	}
+}
+
+//Finds the closest entity a ray hits
+template<uint Dimension, uint Depth>
+bool MySpatialTree<Dimension, Depth>::RaycastFirst(vector3 a_v3Origin, vector3 a_v3Direction, uint& a_uEntity, float& a_fDistance)
+{
+	vector3 inverseDirection = vector3(1.0f) / glm::normalize(a_v3Direction);
+	float closest = std::numeric_limits<float>::max();
+	bool hit = false;
+	uint stack[MAX_LEVEL * (CHILD_COUNT - 1) + 1];
+	uint stackSize = 0;
+	stack[stackSize++] = 0;
+	while(stackSize > 0)
+	{
+		uint node = stack[--stackSize];
+		vector3 minimum;
+		vector3 maximum;
+		GetQueryBounds(node, minimum, maximum);
+		//Nothing under a node the ray reaches after the closest hit can be closer
+		float distance;
+		if(!IntersectRay(a_v3Origin, inverseDirection, minimum, maximum, distance) || distance > closest)
+		{
+			continue;
+		}
+		uint const* entityList = GetEntityList(node);
+		int entityCount = m_lNode[node].m_uEntityCount;
+		for(int i = 0; i < entityCount; i++)
+		{
+			uint entity = entityList[i];
+			if(IntersectRay(a_v3Origin, inverseDirection, m_lEntityMin[entity], m_lEntityMax[entity], distance) && distance < closest)
+			{
+				closest = distance;
+				a_uEntity = entity;
+				hit = true;
+			}
+		}
+		uint childCount = GetChildOffset(m_lNode[node].m_uChildMask, CHILD_COUNT);
+		for(uint i = 0; i < childCount; i++)
+		{
+			stack[stackSize++] = m_lNode[node].m_uFirstChild + i;
+		}
+	}
+	if(hit)
+	{
+		a_fDistance = closest;
+	}
+	return hit;
+}
+
+//Finds every entity a ray hits
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::RaycastAll(vector3 a_v3Origin, vector3 a_v3Direction, std::vector<uint>& a_lEntity)
+{
+	a_lEntity.clear();
+	m_lQueryHit.clear();
+	BeginQuery();
+	vector3 inverseDirection = vector3(1.0f) / glm::normalize(a_v3Direction);
+	uint stack[MAX_LEVEL * (CHILD_COUNT - 1) + 1];
+	uint stackSize = 0;
+	stack[stackSize++] = 0;
+	while(stackSize > 0)
+	{
+		uint node = stack[--stackSize];
+		vector3 minimum;
+		vector3 maximum;
+		GetQueryBounds(node, minimum, maximum);
+		float distance;
+		if(!IntersectRay(a_v3Origin, inverseDirection, minimum, maximum, distance))
+		{
+			continue;
+		}
+		uint const* entityList = GetEntityList(node);
+		int entityCount = m_lNode[node].m_uEntityCount;
+		for(int i = 0; i < entityCount; i++)
+		{
+			uint entity = entityList[i];
+			if(IntersectRay(a_v3Origin, inverseDirection, m_lEntityMin[entity], m_lEntityMax[entity], distance) && MarkEntity(entity))
+			{
+				m_lQueryHit.push_back(std::make_pair(distance, entity));
+			}
+		}
+		uint childCount = GetChildOffset(m_lNode[node].m_uChildMask, CHILD_COUNT);
+		for(uint i = 0; i < childCount; i++)
+		{
+			stack[stackSize++] = m_lNode[node].m_uFirstChild + i;
+		}
+	}
+	std::sort(m_lQueryHit.begin(), m_lQueryHit.end());
+	int hitCount = m_lQueryHit.size();
+	for(int i = 0; i < hitCount; i++)
+	{
+		a_lEntity.push_back(m_lQueryHit[i].second);
+	}
+}
+
+//Finds the entities closest to a point
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::QueryNearest(vector3 a_v3Point, uint a_uCount, std::vector<uint>& a_lEntity)
+{
+	a_lEntity.clear();
+	if(a_uCount == 0)
+	{
+		return;
+	}
+	BeginQuery();
+	//The nodes are visited closest first and the hits are kept in a heap with the farthest on top
+	std::greater<std::pair<float, uint>> closestFirst;
+	m_lQueryNode.clear();
+	m_lQueryHit.clear();
+	vector3 minimum;
+	vector3 maximum;
+	GetQueryBounds(0, minimum, maximum);
+	m_lQueryNode.push_back(std::make_pair(GetDistanceSquared(a_v3Point, minimum, maximum), 0u));
+	while(m_lQueryNode.size() > 0)
+	{
+		std::pop_heap(m_lQueryNode.begin(), m_lQueryNode.end(), closestFirst);
+		float nodeDistance = m_lQueryNode.back().first;
+		uint node = m_lQueryNode.back().second;
+		m_lQueryNode.pop_back();
+		//Every entity left is at least as far as the node
+		if(m_lQueryHit.size() == a_uCount && nodeDistance > m_lQueryHit.front().first)
+		{
+			break;
+		}
+		uint const* entityList = GetEntityList(node);
+		int entityCount = m_lNode[node].m_uEntityCount;
+		for(int i = 0; i < entityCount; i++)
+		{
+			uint entity = entityList[i];
+			if(!MarkEntity(entity))
+			{
+				continue;
+			}
+			float distance = GetDistanceSquared(a_v3Point, m_lEntityMin[entity], m_lEntityMax[entity]);
+			if(m_lQueryHit.size() < a_uCount)
+			{
+				m_lQueryHit.push_back(std::make_pair(distance, entity));
+				std::push_heap(m_lQueryHit.begin(), m_lQueryHit.end());
+			}
+			else if(distance < m_lQueryHit.front().first)
+			{
+				std::pop_heap(m_lQueryHit.begin(), m_lQueryHit.end());
+				m_lQueryHit.back() = std::make_pair(distance, entity);
+				std::push_heap(m_lQueryHit.begin(), m_lQueryHit.end());
+			}
+		}
+		uint childCount = GetChildOffset(m_lNode[node].m_uChildMask, CHILD_COUNT);
+		for(uint i = 0; i < childCount; i++)
+		{
+			uint child = m_lNode[node].m_uFirstChild + i;
+			GetQueryBounds(child, minimum, maximum);
+			m_lQueryNode.push_back(std::make_pair(GetDistanceSquared(a_v3Point, minimum, maximum), child));
+			std::push_heap(m_lQueryNode.begin(), m_lQueryNode.end(), closestFirst);
+		}
+	}
+	std::sort_heap(m_lQueryHit.begin(), m_lQueryHit.end());
+	int hitCount = m_lQueryHit.size();
+	for(int i = 0; i < hitCount; i++)
+	{
+		a_lEntity.push_back(m_lQueryHit[i].second);
+	}
+}
+
+//Gets the bounds a query has to touch to look in a node
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::GetQueryBounds(uint a_uNode, vector3& a_v3Min, vector3& a_v3Max)
+{
+	MyOctantNode& node = m_lNode[a_uNode];
+	if(m_uFlags & OCTANT_LOOSE)
+	{
+		GetLooseBounds(node, a_v3Min, a_v3Max);
+		return;
+	}
+	//Entities stick out of the leafs too, but they are listed in every leaf they reach so any part
+	//of them a query touches is inside a leaf it visits
+	a_v3Min = node.m_v3Min;
+	a_v3Max = node.m_v3Max;
+}
+
+//Starts a query
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::BeginQuery()
+{
+	m_lQueryMark.resize(m_lEntityMin.size(), 0);
+	m_uQueryStamp++;
+	//Starts the marks over when the stamp wraps around
+	if(m_uQueryStamp == 0)
+	{
+		std::fill(m_lQueryMark.begin(), m_lQueryMark.end(), 0);
+		m_uQueryStamp = 1;
+	}
+}
+
+//Marks an entity as reported
+template<uint Dimension, uint Depth>
+bool MySpatialTree<Dimension, Depth>::MarkEntity(uint a_uEntity)
+{
+	if(m_lQueryMark[a_uEntity] == m_uQueryStamp)
+	{
+		return false;
+	}
+	m_lQueryMark[a_uEntity] = m_uQueryStamp;
+	return true;
+}
+
+//Checks if a box touches a query volume
+template<uint Dimension, uint Depth>
+bool MySpatialTree<Dimension, Depth>::IsTouching(MyOctantQuery const& a_Query, vector3 a_v3Min, vector3 a_v3Max)
+{
+	if(a_Query.m_uType == QUERY_SPHERE)
+	{
+		return GetDistanceSquared(a_Query.m_v3Center, a_v3Min, a_v3Max) <= a_Query.m_fRadius * a_Query.m_fRadius;
+	}
+	if(a_Query.m_uType == QUERY_FRUSTUM)
+	{
+		//The box is outside when its corner furthest along the normal of a plane is behind it
+		for(uint i = 0; i < 6; i++)
+		{
+			vector4 const& plane = a_Query.m_v4Plane[i];
+			vector3 corner;
+			for(uint axis = 0; axis < 3; axis++)
+			{
+				corner[axis] = plane[axis] >= 0.0f ? a_v3Max[axis] : a_v3Min[axis];
+			}
+			if(plane.x * corner.x + plane.y * corner.y + plane.z * corner.z + plane.w < 0.0f)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+	for(uint axis = 0; axis < 3; axis++)
+	{
+		if(a_v3Max[axis] < a_Query.m_v3Min[axis] || a_v3Min[axis] > a_Query.m_v3Max[axis])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+//Finds where a ray enters a box
+template<uint Dimension, uint Depth>
+bool MySpatialTree<Dimension, Depth>::IntersectRay(vector3 a_v3Origin, vector3 a_v3InverseDirection, vector3 a_v3Min, vector3 a_v3Max, float& a_fDistance)
+{
+	//Clips the ray against the slab between the planes of the box on each axis
+	float enter = 0.0f;
+	float exit = std::numeric_limits<float>::max();
+	for(uint axis = 0; axis < 3; axis++)
+	{
+		float slabEnter = (a_v3Min[axis] - a_v3Origin[axis]) * a_v3InverseDirection[axis];
+		float slabExit = (a_v3Max[axis] - a_v3Origin[axis]) * a_v3InverseDirection[axis];
+		if(slabEnter > slabExit)
+		{
+			std::swap(slabEnter, slabExit);
+		}
+		enter = std::max(enter, slabEnter);
+		exit = std::min(exit, slabExit);
+		if(enter > exit)
+		{
+			return false;
+		}
+	}
+	a_fDistance = enter;
+	return true;
+}
+
+//Gets the squared distance from a point to a box
+template<uint Dimension, uint Depth>
+float MySpatialTree<Dimension, Depth>::GetDistanceSquared(vector3 a_v3Point, vector3 a_v3Min, vector3 a_v3Max)
+{
+	vector3 closest = glm::clamp(a_v3Point, a_v3Min, a_v3Max);
+	vector3 offset = a_v3Point - closest;
+	return glm::dot(offset, offset);
+}
+
+//Updates only the entities that moved
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::UpdateEntities(std::vector<uint> const& a_lEntity)
+{
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	m_Stats.m_uMovedCount = a_lEntity.size();
+	uint entityCount = m_pEntityMngr->GetEntityCount();
+	std::vector<vector3> const& lProxyMin = m_pEntityMngr->GetProxyMinList();
+	std::vector<vector3> const& lProxyMax = m_pEntityMngr->GetProxyMaxList();
+	uint knownCount = m_lEntityMin.size();
+	//Removed entities shift the indices of the others, so only a rebuild can follow them
+	bool rebuild = entityCount < knownCount;
+	bool listChanged = false;
+	m_lEntityMin.resize(entityCount);
+	m_lEntityMax.resize(entityCount);
+	m_lGrown.clear();
+	m_lShrunk.clear();
+	vector3 rootMin = m_lNode[0].m_v3Min;
+	vector3 rootMax = m_lNode[0].m_v3Max;
+	int movedCount = a_lEntity.size();
+	for(int i = 0; i < movedCount && !rebuild; i++)
+	{
+		uint entity = a_lEntity[i];
+		if(entity >= entityCount)
+		{
+			continue;
+		}
+		vector3 minimum = lProxyMin[entity];
+		vector3 maximum = lProxyMax[entity];
+		//The root does not grow, an entity leaving it needs a new root
+		if(glm::min(minimum, rootMin) != rootMin || glm::max(maximum, rootMax) != rootMax)
+		{
+			rebuild = true;
+			break;
+		}
+		//Creating the octants a sparse tree is missing moves nodes, so it is done before any leaf index is kept
+		if((m_uFlags & OCTANT_SPARSE) && !(m_uFlags & OCTANT_LOOSE))
+		{
+			listChanged = AddMissingChildren(minimum, maximum) || listChanged;
+		}
+	}
+	for(int i = 0; i < movedCount && !rebuild; i++)
+	{
+		uint entity = a_lEntity[i];
+		if(entity >= entityCount)
+		{
+			continue;
+		}
+		vector3 minimum = lProxyMin[entity];
+		vector3 maximum = lProxyMax[entity];
+		//The tree still matches the old bounds so descending with them finds the leafs it was in
+		m_lOldLeaf.clear();
+		if(entity < knownCount)
+		{
+			FindEntityNodes(m_lEntityMin[entity], m_lEntityMax[entity], m_lOldLeaf);
+		}
+		FindEntityNodes(minimum, maximum, m_lNewLeaf);
+		m_lEntityMin[entity] = minimum;
+		m_lEntityMax[entity] = maximum;
+		std::sort(m_lOldLeaf.begin(), m_lOldLeaf.end());
+		std::sort(m_lNewLeaf.begin(), m_lNewLeaf.end());
+		//Walks both sorted lists touching only the leafs that differ
+		uint oldIndex = 0;
+		uint newIndex = 0;
+		while(oldIndex < m_lOldLeaf.size() || newIndex < m_lNewLeaf.size())
+		{
+			if(newIndex >= m_lNewLeaf.size() || (oldIndex < m_lOldLeaf.size() && m_lOldLeaf[oldIndex] < m_lNewLeaf[newIndex]))
+			{
+				//Left this leaf
+				uint leaf = m_lOldLeaf[oldIndex++];
+				EraseEntity(leaf, entity);
+				RemoveEntityDimension(entity, leaf);
+				m_lShrunk.push_back(leaf);
+				listChanged = listChanged || m_lNode[leaf].m_uEntityCount == 0;
+			}
+			else if(oldIndex >= m_lOldLeaf.size() || m_lNewLeaf[newIndex] < m_lOldLeaf[oldIndex])
+			{
+				//Entered this leaf
+				uint leaf = m_lNewLeaf[newIndex++];
+				PushEntity(leaf, entity);
+				AddEntityDimension(entity, leaf);
+				m_lGrown.push_back(leaf);
+				listChanged = listChanged || m_lNode[leaf].m_uEntityCount == 1;
+			}
+			else
+			{
+				//Stayed in this leaf
+				oldIndex++;
+				newIndex++;
+			}
+		}
+	}
+	if(rebuild)
+	{
+		if(!(m_uFlags & OCTANT_DETACHED))
+		{
+			m_pEntityMngr->ClearDimensionSetAll();
+		}
+		CopyEntityBounds();
+		FitRootToEntities();
+		BuildTree();
+		AssignIDtoEntity();
+		m_Stats.m_fUpdateTime = GetMillisecondsSince(start);
+		return;
+	}
+	//Splits the leafs that grew past the ideal count, new children that are still too big are
+	//appended to the list so they are split too
+	for(uint i = 0; i < m_lGrown.size(); i++)
+	{
+		uint leaf = m_lGrown[i];
+		MyOctantNode& node = m_lNode[leaf];
+		if(node.m_uKey != 0 && IsLeaf(leaf) && node.m_uLevel < m_uMaxLevel && node.m_uEntityCount > GetSplitCount())
+		{
+			SplitLeaf(leaf);
+			listChanged = true;
+		}
+	}
+	//Collapses the parents of the leafs that shrank for as long as their children fit in them
+	int shrunkCount = m_lShrunk.size();
+	for(int i = 0; i < shrunkCount; i++)
+	{
+		//In a loose tree the node that shrank can be the one to collapse
+		uint parent = IsLeaf(m_lShrunk[i]) ? GetParent(m_lShrunk[i]) : m_lShrunk[i];
+		while(parent != INVALID_NODE && CanCollapse(parent))
+		{
+			CollapseNode(parent);
+			listChanged = true;
+			parent = GetParent(parent);
+		}
+	}
+	if(listChanged)
+	{
+		m_lChild.clear();
+		ConstructList();
+	}
+	//Ranges that outgrew their slots left them behind, once those are most of the array it is rebuilt tight
+	if(m_uEntityGarbage > m_lEntity.size() / 2)
+	{
+		CompactEntities(m_lEntity);
+	}
+	m_Stats.m_fUpdateTime = GetMillisecondsSince(start);
+}
+
+//Updates the entities whose bounds changed
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::UpdateEntities()
+{
+	uint entityCount = m_pEntityMngr->GetEntityCount();
+	uint knownCount = m_lEntityMin.size();
+	m_lMoved.clear();
+	std::vector<vector3> const& lProxyMin = m_pEntityMngr->GetProxyMinList();
+	std::vector<vector3> const& lProxyMax = m_pEntityMngr->GetProxyMaxList();
+	for(uint i = 0; i < entityCount; i++)
+	{
+		if(i >= knownCount)
+		{
+			m_lMoved.push_back(i);
+			continue;
+		}
+		if(lProxyMin[i] != m_lEntityMin[i] || lProxyMax[i] != m_lEntityMax[i])
+		{
+			m_lMoved.push_back(i);
+		}
+	}
+	UpdateEntities(m_lMoved);
+}
+
+//Subdivides a leaf and moves its entities to the children
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::SplitLeaf(uint a_uNode)
+{
+	if(!IsLeaf(a_uNode) || m_lNode[a_uNode].m_uLevel >= m_uMaxLevel)
+	{
+		return;
+	}
+	//Counts what each child would get the same way the build does
+	uint childMask = 0;
+	uint entityChildCount[CHILD_COUNT] = { 0 };
+	uint stayCount = 0;
+	int entityCount = m_lNode[a_uNode].m_uEntityCount;
+	for(int i = 0; i < entityCount; i++)
+	{
+		uint mask = GetEntityChildMask(m_lNode[a_uNode], GetEntityList(a_uNode)[i]);
+		for(uint j = 0; j < CHILD_COUNT; j++)
+		{
+			entityChildCount[j] += (mask >> j) & 1;
+		}
+		stayCount += mask == 0 ? 1 : 0;
+		childMask |= mask;
+	}
+	//Nothing to split if every entity of a loose leaf stays in it
+	if(childMask == 0 || !ShouldSplit(entityCount, stayCount, entityChildCount))
+	{
+		return;
+	}
+	//A sparse tree only creates the children the entities of the leaf reach
+	if(!(m_uFlags & OCTANT_SPARSE))
+	{
+		childMask = FULL_CHILD_MASK;
+	}
+	uint childCount = GetChildOffset(childMask, CHILD_COUNT);
+	uint firstChild = AllocateBlock(childCount);
+	m_lNode[a_uNode].m_uFirstChild = firstChild;
+	m_lNode[a_uNode].m_uChildMask = childMask;
+	MakeChildren(m_lNode[a_uNode], a_uNode, &m_lNode[firstChild]);
+	//Sizes the ranges of the children up front so none of them moves while the entities are handed down
+	for(uint j = 0; j < CHILD_COUNT; j++)
+	{
+		if(childMask & (1 << j))
+		{
+			ReserveEntities(firstChild + GetChildOffset(childMask, j), entityChildCount[j]);
+		}
+	}
+	//The entities of a loose leaf that fit in no child stay in it
+	uint* entityList = m_lEntity.data() + m_lNode[a_uNode].m_uEntityBegin;
+	int keptCount = 0;
+	for(int i = 0; i < entityCount; i++)
+	{
+		uint entity = entityList[i];
+		uint mask = GetEntityChildMask(m_lNode[a_uNode], entity);
+		if(mask == 0)
+		{
+			entityList[keptCount++] = entity;
+			continue;
+		}
+		for(uint j = 0; j < CHILD_COUNT; j++)
+		{
+			if(mask & (1 << j))
+			{
+				uint child = firstChild + GetChildOffset(childMask, j);
+				PushEntity(child, entity);
+				AddEntityDimension(entity, child);
+			}
+		}
+		RemoveEntityDimension(entity, a_uNode);
+	}
+	m_lNode[a_uNode].m_uEntityCount = keptCount;
+	if(keptCount == 0)
+	{
+		ReleaseEntities(a_uNode);
+	}
+	//The children are checked the same way the leafs that grew are
+	for(uint j = 0; j < childCount; j++)
+	{
+		m_lGrown.push_back(firstChild + j);
+	}
+}
+
+//Checks if the children of a node can be merged back in to it
+template<uint Dimension, uint Depth>
+bool MySpatialTree<Dimension, Depth>::CanCollapse(uint a_uNode)
+{
+	if(m_lNode[a_uNode].m_uKey == 0 || IsLeaf(a_uNode))
+	{
+		return false;
+	}
+	//Counting straddlers once per child keeps collapsing conservative so nodes do not flip every frame
+	uint firstChild = m_lNode[a_uNode].m_uFirstChild;
+	uint childMask = m_lNode[a_uNode].m_uChildMask;
+	uint stayCount = m_lNode[a_uNode].m_uEntityCount;
+	uint count = stayCount;
+	uint childCount[CHILD_COUNT] = { 0 };
+	for(uint j = 0; j < CHILD_COUNT; j++)
+	{
+		if(!(childMask & (1 << j)))
+		{
+			continue;
+		}
+		uint child = firstChild + GetChildOffset(childMask, j);
+		if(!IsLeaf(child))
+		{
+			return false;
+		}
+		childCount[j] = m_lNode[child].m_uEntityCount;
+		count += childCount[j];
+	}
+	return !ShouldSplit(count, stayCount, childCount);
+}
+
+//Merges the children of a node in to it
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::CollapseNode(uint a_uNode)
+{
+	uint firstChild = m_lNode[a_uNode].m_uFirstChild;
+	uint childCount = GetChildOffset(m_lNode[a_uNode].m_uChildMask, CHILD_COUNT);
+	uint const* entityList = GetEntityList(a_uNode);
+	m_lMerge.assign(entityList, entityList + m_lNode[a_uNode].m_uEntityCount);
+	for(uint j = 0; j < childCount; j++)
+	{
+		uint const* childList = GetEntityList(firstChild + j);
+		int childEntityCount = m_lNode[firstChild + j].m_uEntityCount;
+		for(int i = 0; i < childEntityCount; i++)
+		{
+			RemoveEntityDimension(childList[i], firstChild + j);
+			m_lMerge.push_back(childList[i]);
+		}
+	}
+	//Entities straddling the children were listed more than once
+	std::sort(m_lMerge.begin(), m_lMerge.end());
+	m_lMerge.erase(std::unique(m_lMerge.begin(), m_lMerge.end()), m_lMerge.end());
+	int entityCount = m_lMerge.size();
+	ReserveEntities(a_uNode, entityCount);
+	std::copy(m_lMerge.begin(), m_lMerge.end(), m_lEntity.begin() + m_lNode[a_uNode].m_uEntityBegin);
+	m_lNode[a_uNode].m_uEntityCount = entityCount;
+	for(int i = 0; i < entityCount; i++)
+	{
+		AddEntityDimension(m_lMerge[i], a_uNode);
+	}
+	m_lNode[a_uNode].m_uFirstChild = 0;
+	m_lNode[a_uNode].m_uChildMask = 0;
+	//Releases the children so their block can be reused by the next subdivision
+	ReleaseBlock(firstChild, childCount);
+}
+
+//Adds a node to the dimensions of an entity
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::AddEntityDimension(uint a_uEntity, uint a_uNode)
+{
+	if(!(m_uFlags & OCTANT_DETACHED))
+	{
+		m_pEntityMngr->AddDimension(a_uEntity, a_uNode);
+	}
+}
+
+//Removes a node from the dimensions of an entity
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::RemoveEntityDimension(uint a_uEntity, uint a_uNode)
+{
+	if(!(m_uFlags & OCTANT_DETACHED))
+	{
+		m_pEntityMngr->RemoveDimension(a_uEntity, a_uNode);
+	}
+}
+
+//Makes room in the entity range of a node
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::ReserveEntities(uint a_uNode, uint a_uCount)
+{
+	MyOctantNode& node = m_lNode[a_uNode];
+	if(a_uCount <= node.m_uEntityCapacity)
+	{
+		return;
+	}
+	//Doubling the capacity keeps a leaf that keeps receiving entities from moving every frame
+	uint capacity = std::max(a_uCount, node.m_uEntityCapacity * 2);
+	uint arraySize = m_lEntity.size();
+	//The range at the end of the array grows in place
+	if(node.m_uEntityCapacity > 0 && node.m_uEntityBegin + node.m_uEntityCapacity == arraySize)
+	{
+		m_lEntity.resize(node.m_uEntityBegin + capacity);
+		node.m_uEntityCapacity = capacity;
+		return;
+	}
+	m_lEntity.resize(arraySize + capacity);
+	std::vector<uint>::iterator begin = m_lEntity.begin() + node.m_uEntityBegin;
+	std::copy(begin, begin + node.m_uEntityCount, m_lEntity.begin() + arraySize);
+	m_uEntityGarbage += node.m_uEntityCapacity;
+	node.m_uEntityBegin = arraySize;
+	node.m_uEntityCapacity = capacity;
+}
+
+//Adds an entity to the entity range of a node
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::PushEntity(uint a_uNode, uint a_uEntity)
+{
+	ReserveEntities(a_uNode, m_lNode[a_uNode].m_uEntityCount + 1);
+	MyOctantNode& node = m_lNode[a_uNode];
+	m_lEntity[node.m_uEntityBegin + node.m_uEntityCount++] = a_uEntity;
+}
+
+//Removes an entity from the entity range of a node
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::EraseEntity(uint a_uNode, uint a_uEntity)
+{
+	MyOctantNode& node = m_lNode[a_uNode];
+	uint* entityList = m_lEntity.data() + node.m_uEntityBegin;
+	for(uint i = 0; i < node.m_uEntityCount; i++)
+	{
+		if(entityList[i] == a_uEntity)
+		{
+			entityList[i] = entityList[--node.m_uEntityCount];
+			return;
+		}
+	}
+}
+
+//Empties the entity range of a node
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::ReleaseEntities(uint a_uNode)
+{
+	MyOctantNode& node = m_lNode[a_uNode];
+	m_uEntityGarbage += node.m_uEntityCapacity;
+	node.m_uEntityBegin = 0;
+	node.m_uEntityCount = 0;
+	node.m_uEntityCapacity = 0;
+}
+
+//Lays the entity ranges of the nodes back to back
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::CompactEntities(std::vector<uint> const& a_lSource)
+{
+	//Counts the entries first so the new array is sized once, every node holding entities is in the leaf list
+	uint entryCount = 0;
+	int leafCount = m_lChild.size();
+	for(int i = 0; i < leafCount; i++)
+	{
+		entryCount += m_lNode[m_lChild[i]].m_uEntityCount;
+	}
+	std::vector<uint> lEntity(entryCount);
+	uint offset = 0;
+	for(int i = 0; i < leafCount; i++)
+	{
+		MyOctantNode& node = m_lNode[m_lChild[i]];
+		std::vector<uint>::const_iterator begin = a_lSource.begin() + node.m_uEntityBegin;
+		std::copy(begin, begin + node.m_uEntityCount, lEntity.begin() + offset);
+		node.m_uEntityBegin = offset;
+		node.m_uEntityCapacity = node.m_uEntityCount;
+		offset += node.m_uEntityCount;
+	}
+	//The empty nodes own no slots
+	int nodeCount = m_lNode.size();
+	for(int i = 0; i < nodeCount; i++)
+	{
+		if(m_lNode[i].m_uEntityCount == 0)
+		{
+			m_lNode[i].m_uEntityBegin = 0;
+			m_lNode[i].m_uEntityCapacity = 0;
+		}
+	}
+	m_lEntity.swap(lEntity);
+	m_uEntityGarbage = 0;
+}
+
+//Assign the index of the leafs to the entities inside them
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::AssignIDtoEntity()
+{
+	int nodeCount = m_lNode.size();
+	for(int i = 0; i < nodeCount; i++)
+	{
+		uint const* entityList = GetEntityList(i);
+		int entityCount = m_lNode[i].m_uEntityCount;
+		for(int j = 0; j < entityCount; j++)
+		{
+			AddEntityDimension(entityList[j], i);
+		}
+	}
+}
+
+//Writes the tree to a file
+template<uint Dimension, uint Depth>
+bool MySpatialTree<Dimension, Depth>::SaveSnapshot(String a_sFileName)
+{
+	//Flattens the entity ranges without their slack so every part of the file is a single write
+	uint nodeCount = m_lNode.size();
+	std::vector<MyOctantSnapshotNode> lNode(nodeCount);
+	std::vector<uint> lIndex;
+	for(uint i = 0; i < nodeCount; i++)
+	{
+		MyOctantNode const& node = m_lNode[i];
+		MyOctantSnapshotNode& record = lNode[i];
+		record.m_uKey = node.m_uKey;
+		record.m_uLevel = node.m_uLevel;
+		record.m_uParent = node.m_uParent;
+		record.m_uFirstChild = node.m_uFirstChild;
+		record.m_uChildMask = node.m_uChildMask;
+		record.m_fSize = node.m_fSize;
+		record.m_v3Center = node.m_v3Center;
+		record.m_v3Min = node.m_v3Min;
+		record.m_v3Max = node.m_v3Max;
+		record.m_uEntityBegin = lIndex.size();
+		record.m_uEntityCount = node.m_uEntityCount;
+		std::vector<uint>::const_iterator begin = m_lEntity.begin() + node.m_uEntityBegin;
+		lIndex.insert(lIndex.end(), begin, begin + node.m_uEntityCount);
+	}
+	MyOctantSnapshotHeader header;
+	header.m_uMagic = SNAPSHOT_MAGIC;
+	header.m_uVersion = SNAPSHOT_VERSION;
+	header.m_uMaxLevel = m_uMaxLevel;
+	header.m_uIdealEntityCount = m_uIdealEntityCount;
+	header.m_uFlags = m_uFlags;
+	header.m_uEntityCount = m_lEntityMin.size();
+	header.m_uBoundsHash = GetBoundsHash(m_lEntityMin, m_lEntityMax);
+	header.m_uNodeCount = nodeCount;
+	header.m_uIndexCount = lIndex.size();
+	header.m_uLeafCount = m_lChild.size();
+	for(uint i = 0; i < CHILD_COUNT; i++)
+	{
+		header.m_uFreeCount[i] = m_lFreeBlock[i].size();
+	}
+
+	std::ofstream file(a_sFileName, std::ios::binary);
+	if(!file)
+	{
+		return false;
+	}
+	file.write((char const*)&header, sizeof(header));
+	file.write((char const*)lNode.data(), sizeof(MyOctantSnapshotNode) * nodeCount);
+	file.write((char const*)lIndex.data(), sizeof(uint) * lIndex.size());
+	file.write((char const*)m_lChild.data(), sizeof(uint) * m_lChild.size());
+	for(uint i = 0; i < CHILD_COUNT; i++)
+	{
+		file.write((char const*)m_lFreeBlock[i].data(), sizeof(uint) * m_lFreeBlock[i].size());
+	}
+	file.close();
+	return !file.fail();
+}
+
+//Reads the tree from a file
+template<uint Dimension, uint Depth>
+bool MySpatialTree<Dimension, Depth>::LoadSnapshot(String a_sFileName)
+{
+	std::ifstream file(a_sFileName, std::ios::binary | std::ios::ate);
+	if(!file)
+	{
+		return false;
+	}
+	//Reads the whole file in one go and checks it there; the tree is only replaced once every record
+	//passed, by copying the records in to its own arrays since updates keep changing them afterwards
+	long long fileSize = file.tellg();
+	file.seekg(0, std::ios::beg);
+	std::vector<char> lData;
+	if(fileSize > 0)
+	{
+		lData.resize((size_t)fileSize);
+	}
+	bool read = fileSize >= (long long)sizeof(MyOctantSnapshotHeader) && file.read(lData.data(), fileSize);
+	file.close();
+	if(!read)
+	{
+		return false;
+	}
+	MyOctantSnapshotHeader header;
+	memcpy(&header, lData.data(), sizeof(header));
+	//The parallel build makes the same tree as the serial one
+	if(header.m_uMagic != SNAPSHOT_MAGIC || header.m_uVersion != SNAPSHOT_VERSION ||
+		header.m_uMaxLevel != m_uMaxLevel || header.m_uIdealEntityCount != m_uIdealEntityCount ||
+		(header.m_uFlags & ~OCTANT_PARALLEL) != (m_uFlags & ~OCTANT_PARALLEL) || header.m_uNodeCount == 0)
+	{
+		return false;
+	}
+	size_t indexCount = (size_t)header.m_uIndexCount + header.m_uLeafCount;
+	for(uint i = 0; i < CHILD_COUNT; i++)
+	{
+		indexCount += header.m_uFreeCount[i];
+	}
+	if((size_t)fileSize != sizeof(header) + sizeof(MyOctantSnapshotNode) * (size_t)header.m_uNodeCount + sizeof(uint) * indexCount)
+	{
+		return false;
+	}
+	//The tree only holds for the bounds it was built over
+	uint entityCount = m_pEntityMngr->GetEntityCount();
+	if(header.m_uEntityCount != entityCount)
+	{
+		return false;
+	}
+	std::vector<vector3> const& lEntityMin = m_pEntityMngr->GetProxyMinList();
+	std::vector<vector3> const& lEntityMax = m_pEntityMngr->GetProxyMaxList();
+	if(header.m_uBoundsHash != GetBoundsHash(lEntityMin, lEntityMax))
+	{
+		return false;
+	}
+	//A damaged file must not leave indices that reach outside the arrays
+	MyOctantSnapshotNode const* pNode = (MyOctantSnapshotNode const*)(lData.data() + sizeof(header));
+	uint const* pIndex = (uint const*)(pNode + header.m_uNodeCount);
+	uint const* pLeaf = pIndex + header.m_uIndexCount;
+	if(pNode[0].m_uKey != 1 || pNode[0].m_uLevel != 0 || pNode[0].m_uParent != 0)
+	{
+		return false;
+	}
+	for(uint i = 0; i < header.m_uNodeCount; i++)
+	{
+		MyOctantSnapshotNode const& record = pNode[i];
+		if(record.m_uParent >= header.m_uNodeCount || record.m_uChildMask > FULL_CHILD_MASK ||
+			(size_t)record.m_uFirstChild + GetChildOffset(record.m_uChildMask, CHILD_COUNT) > header.m_uNodeCount ||
+			(size_t)record.m_uEntityBegin + record.m_uEntityCount > header.m_uIndexCount)
+		{
+			return false;
+		}
+		if(record.m_uKey == 0)
+		{
+			continue;
+		}
+		//The levels have to go up by one along every link so no walk through the tree can come back around
+		if(record.m_uLevel > m_uMaxLevel || (record.m_uFirstChild == 0) != (record.m_uChildMask == 0))
+		{
+			return false;
+		}
+		if(i != 0)
+		{
+			MyOctantSnapshotNode const& parent = pNode[record.m_uParent];
+			if(parent.m_uKey == 0 || parent.m_uLevel + 1 != record.m_uLevel)
+			{
+				return false;
+			}
+		}
+		for(uint j = 0; j < CHILD_COUNT; j++)
+		{
+			if(!(record.m_uChildMask & (1 << j)))
+			{
+				continue;
+			}
+			uint child = record.m_uFirstChild + GetChildOffset(record.m_uChildMask, j);
+			if(pNode[child].m_uParent != i || pNode[child].m_uLevel != record.m_uLevel + 1 ||
+				pNode[child].m_uKey != ((record.m_uKey << Dimension) | j))
+			{
+				return false;
+			}
+		}
+	}
+	for(size_t i = 0; i < indexCount; i++)
+	{
+		uint limit = i < header.m_uIndexCount ? entityCount : header.m_uNodeCount;
+		if(pIndex[i] >= limit)
+		{
+			return false;
+		}
+	}
+	//A free block handed out again has to hold only released nodes
+	uint const* pFreeBlock = pLeaf + header.m_uLeafCount;
+	for(uint i = 0; i < CHILD_COUNT; i++)
+	{
+		for(uint j = 0; j < header.m_uFreeCount[i]; j++)
+		{
+			uint first = *pFreeBlock++;
+			if((size_t)first + i + 1 > header.m_uNodeCount)
+			{
+				return false;
+			}
+			for(uint k = 0; k <= i; k++)
+			{
+				if(pNode[first + k].m_uKey != 0)
+				{
+					return false;
+				}
+			}
+		}
+	}
+	//The entity ranges are laid out in leaf list order, so the list has to be every node holding entities in order
+	uint leafCount = 0;
+	for(uint i = 0; i < header.m_uNodeCount; i++)
+	{
+		if(pNode[i].m_uEntityCount == 0)
+		{
+			continue;
+		}
+		if(leafCount >= header.m_uLeafCount || pLeaf[leafCount] != i)
+		{
+			return false;
+		}
+		leafCount++;
+	}
+	if(leafCount != header.m_uLeafCount)
+	{
+		return false;
+	}
+
+	if(!(m_uFlags & OCTANT_DETACHED))
+	{
+		m_pEntityMngr->ClearDimensionSetAll();
+	}
+	m_lNode.clear();
+	m_lNode.resize(header.m_uNodeCount);
+	for(uint i = 0; i < header.m_uNodeCount; i++)
+	{
+		MyOctantSnapshotNode const& record = pNode[i];
+		MyOctantNode& node = m_lNode[i];
+		node.m_uKey = record.m_uKey;
+		node.m_uLevel = record.m_uLevel;
+		node.m_uParent = record.m_uParent;
+		node.m_uFirstChild = record.m_uFirstChild;
+		node.m_uChildMask = record.m_uChildMask;
+		node.m_fSize = record.m_fSize;
+		node.m_v3Center = record.m_v3Center;
+		node.m_v3Min = record.m_v3Min;
+		node.m_v3Max = record.m_v3Max;
+		node.m_uEntityBegin = record.m_uEntityBegin;
+		node.m_uEntityCount = record.m_uEntityCount;
+		node.m_uEntityCapacity = record.m_uEntityCount;
+	}
+	m_lChild.assign(pLeaf, pLeaf + header.m_uLeafCount);
+	//Copying each range on its own keeps a file whose ranges overlap from sharing slots between nodes
+	std::vector<uint> lIndex(pIndex, pIndex + header.m_uIndexCount);
+	CompactEntities(lIndex);
+	uint const* pFree = pLeaf + header.m_uLeafCount;
+	for(uint i = 0; i < CHILD_COUNT; i++)
+	{
+		m_lFreeBlock[i].assign(pFree, pFree + header.m_uFreeCount[i]);
+		pFree += header.m_uFreeCount[i];
+	}
+	m_lEntityMin = lEntityMin;
+	m_lEntityMax = lEntityMax;
+	AssignIDtoEntity();
+	return true;
+}
+
+//Hashes the bounds of the entities
+template<uint Dimension, uint Depth>
+unsigned long long MySpatialTree<Dimension, Depth>::GetBoundsHash(std::vector<vector3> const& a_lEntityMin, std::vector<vector3> const& a_lEntityMax)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	uint entityCount = a_lEntityMin.size();
+	for(uint i = 0; i < entityCount; i++)
+	{
+		vector3 bounds[2] = { a_lEntityMin[i], a_lEntityMax[i] };
+		unsigned char const* pByte = (unsigned char const*)bounds;
+		for(uint j = 0; j < sizeof(bounds); j++)
+		{
+			hash ^= pByte[j];
+			hash *= 1099511628211ULL;
+		}
+	}
+	return hash;
+}
+
+//Release the octant (used in the destructor)
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::Release()
+{
+	m_lNode.clear();
+	m_lChild.clear();
+	m_lEntity.clear();
+	m_uEntityGarbage = 0;
+	for(uint i = 0; i < CHILD_COUNT; i++)
+	{
+		m_lFreeBlock[i].clear();
+	}
+}
+
+//Initialize the octant with only a root node
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::Init()
+{
+	m_pMeshMngr = MeshManager::GetInstance();
+	m_pEntityMngr = MyEntityManager::GetInstance();
+	m_lNode.clear();
+	m_lNode.push_back(MyOctantNode());
+	m_lChild.clear();
+	m_lEntity.clear();
+	m_uEntityGarbage = 0;
+	for(uint i = 0; i < CHILD_COUNT; i++)
+	{
+		m_lFreeBlock[i].clear();
+	}
+}
+
+//Creates the list of leafs that have objects
+template<uint Dimension, uint Depth>
+void MySpatialTree<Dimension, Depth>::ConstructList()
+{
+	int nodeCount = m_lNode.size();
+	for(int i = 0; i < nodeCount; i++)
+	{
+		if(m_lNode[i].m_uEntityCount > 0)
+		{
+			m_lChild.push_back(i);
+		}
+	}
+}
+
+//The trees the rest of the code uses, the members are only defined in this file
+template class Simplex::MySpatialTree<3, 10>;
+template class Simplex::MySpatialTree<2, 15>;
@@ -1,35 +1,172 @@
 #pragma once
 
-#include "MyEntityManager.h"
+#include "MyBroadPhase.h"
+#include <chrono>
 
 namespace Simplex
 {
-	class MyOctant
+	//Node of the linear octree, nodes live in one contiguous array and never point to each other
+	struct MyOctantNode
 	{
-		static uint m_uOctantCount; //will store the number of octants initialized
-		static uint m_uMaxLevel; //will store the maximum level an octant can go to
-		static uint m_uIdealEntityCount; //will tell how many ideal entities this object will contain
+		uint m_uKey = 1; //morton locational code of the node (a sentinel bit followed by one bit per split axis per level)
+		uint m_uLevel = 0; //level of the node in the tree
+		uint m_uParent = 0; //index of the parent node (the root is its own parent)
+		uint m_uFirstChild = 0; //index of the first of the consecutive children, 0 if the node is a leaf
+		uint m_uChildMask = 0; //bit i is set when the child with morton index i exists, children are stored in bit order
 
-		uint m_uID = 0; //will store the current ID for this octant
-		uint m_uLevel = 0; //will store the current level of the octant
-		uint m_uChildren = 0; //number of children on the octant
+		float m_fSize = 0.0f; //size of the node along the split axes
 
-		float m_fSize = 0.0f; //size of the octant
+		vector3 m_v3Center = vector3(0.0f); //center point of the node
+		vector3 m_v3Min = vector3(0.0f); //minimum vector of the node
+		vector3 m_v3Max = vector3(0.0f); //maximum vector of the node
+
+		uint m_uEntityBegin = 0; //first slot of the node's range in the entity array of the tree (or of the branch while building)
+		uint m_uEntityCount = 0; //number of entities under this node (index in entity manager)
+		uint m_uEntityCapacity = 0; //slots the range holds before it has to move to the end of the entity array
+	};
+
+	//Nodes and entity ranges of a branch of the tree while it is being built
+	struct MyOctantBranch
+	{
+		std::vector<MyOctantNode> m_lNode; //nodes of the branch, the first one is the root of the branch
+		std::vector<uint> m_lIndex; //entity indices partitioned by node, the entity ranges of the built nodes point in to it
+		std::vector<uint> m_lBegin; //start of the range of each node in the index array
+		std::vector<uint> m_lCount; //size of the range of each node in the index array
+		std::vector<unsigned char> m_lMask; //children each entity of the node being partitioned overlaps
+	};
+
+	//Options changing how the tree is built
+	enum eOctantFlags
+	{
+		OCTANT_DEFAULT = 0, //serial build
+		OCTANT_PARALLEL = 1, //branches below PARALLEL_LEVEL are built as tasks on a pool of worker threads
+		OCTANT_SPARSE = 2, //only the children that hold entities are created
+		OCTANT_LOOSE = 4, //nodes reach twice their size and each entity is held once, by the deepest node it fits in
+		OCTANT_ADAPTIVE = 8, //nodes split only where the estimated pair tests drop, the ideal entity count is ignored
+		OCTANT_DETACHED = 16, //the tree never writes its nodes in to the dimensions of the entities, so other trees can run beside it
+	};
+
+	//Kinds of volume a query looks for entities in
+	enum eOctantQuery
+	{
+		QUERY_BOX = 0, //box going from m_v3Min to m_v3Max
+		QUERY_SPHERE = 1, //sphere at m_v3Center with a radius of m_fRadius
+		QUERY_FRUSTUM = 2, //volume inside the 6 planes of m_v4Plane
+	};
+
+	//Volume a query looks for entities in
+	struct MyOctantQuery
+	{
+		uint m_uType = QUERY_BOX; //eOctantQuery
+		vector3 m_v3Min = vector3(0.0f); //minimum of the box
+		vector3 m_v3Max = vector3(0.0f); //maximum of the box
+		vector3 m_v3Center = vector3(0.0f); //center of the sphere
+		float m_fRadius = 0.0f; //radius of the sphere
+		vector4 m_v4Plane[6]; //planes of the frustum as (normal, distance), the inside is where dot(normal, point) + distance >= 0
+	};
+
+	//Start of a snapshot file, followed by m_uNodeCount MyOctantSnapshotNode, m_uIndexCount entity indices,
+	//m_uLeafCount leaf indices and m_uFreeCount[i] first indices of the free blocks of each size
+	struct MyOctantSnapshotHeader
+	{
+		uint m_uMagic = 0; //identifies the file as an octree snapshot
+		uint m_uVersion = 0; //layout of the file
+		uint m_uMaxLevel = 0; //maximum level of the tree
+		uint m_uIdealEntityCount = 0; //ideal entity count of the tree
+		uint m_uFlags = 0; //eOctantFlags of the tree
+		uint m_uEntityCount = 0; //number of entities the tree was built over
+		unsigned long long m_uBoundsHash = 0; //hash of the bounds of every entity the tree was built over
+		uint m_uNodeCount = 0; //number of node records
+		uint m_uIndexCount = 0; //number of entity indices of all the nodes
+		uint m_uLeafCount = 0; //number of indices in the leaf list
+		uint m_uFreeCount[8] = { 0, 0, 0, 0, 0, 0, 0, 0 }; //number of free blocks of each size, a quadtree only uses the first 4
+	};
+
+	//Node of a snapshot file, the entity list is a range of the entity indices that follow the nodes
+	struct MyOctantSnapshotNode
+	{
+		uint m_uKey = 0; //morton locational code of the node
+		uint m_uLevel = 0; //level of the node in the tree
+		uint m_uParent = 0; //index of the parent node
+		uint m_uFirstChild = 0; //index of the first child, 0 if the node is a leaf
+		uint m_uChildMask = 0; //children the node has
+		float m_fSize = 0.0f; //size of the node
+		vector3 m_v3Center = vector3(0.0f); //center point of the node
+		vector3 m_v3Min = vector3(0.0f); //minimum vector of the node
+		vector3 m_v3Max = vector3(0.0f); //maximum vector of the node
+		uint m_uEntityBegin = 0; //first entity index of the node
+		uint m_uEntityCount = 0; //number of entity indices of the node
+	};
+
+	//Measurements of a tree, the times and pair counts are recorded as the tree runs and the rest is
+	//counted when GetStats is called
+	struct MyOctantStats
+	{
+		float m_fBuildTime = 0.0f; //milliseconds the last full build took
+		float m_fUpdateTime = 0.0f; //milliseconds the last incremental update took (builds included)
+		float m_fPairTime = 0.0f; //milliseconds the last GetCandidatePairs took
+		uint m_uMovedCount = 0; //entities the last incremental update moved
+		unsigned long long m_uTestedPairCount = 0; //pairs of bounds the last GetCandidatePairs compared
+		uint m_uCandidatePairCount = 0; //pairs of overlapping bounds the last GetCandidatePairs listed
+
+		std::vector<uint> m_lLevelNodeCount; //nodes on each level
+		std::vector<uint> m_lLevelLeafCount; //leafs on each level
+		uint m_uOccupancy[8] = { 0, 0, 0, 0, 0, 0, 0, 0 }; //leafs holding 0, 1, 2, 3-4, 5-8, 9-16, 17-32 and 33 or more entities
+		uint m_uEntryCount = 0; //entity indices listed by all the nodes
+		uint m_uStraddlerCount = 0; //entities listed by more than one leaf, or held above the leafs in a loose tree
+	};
+
+	//Linear tree splitting every node in to 2^Dimension children on the center of the node, an octree
+	//splits x, y and z and a quadtree splits x and z only, so its nodes keep the height of the root;
+	//the settings are compile time constants so neither tree branches on them while it runs
+	template<uint Dimension, uint Depth>
+	class MySpatialTree : public MyBroadPhase
+	{
+		static_assert(Dimension == 2 || Dimension == 3, "the tree splits either 2 or 3 axes");
+		static_assert(Depth * Dimension < 32, "the locational codes of the deepest level have to fit in 32 bits");
+
+	public:
+		static const uint DIMENSION = Dimension; //axes split by every subdivision
+		static const uint CHILD_COUNT = 1 << Dimension; //children of a subdivided node
+		static const uint FULL_CHILD_MASK = (1 << CHILD_COUNT) - 1; //child mask of a node with every child
+		static const uint MAX_LEVEL = Depth; //deepest level a locational code can address
+		static const uint PARALLEL_LEVEL = 2; //level at which a parallel build hands branches to the workers
+		static const uint INVALID_NODE = (uint)-1; //returned when a node does not exist
+		static const uint SPLIT_NODE_COST = 2; //pair tests an adaptive tree charges for creating and visiting a child
+		static const uint SPLIT_ENTRY_COST = 1; //pair tests an adaptive tree charges for each entity handed to a child
+		static const uint SNAPSHOT_MAGIC = Dimension == 3 ? 0x5443304D : 0x5451304D; //"M0CT" or "M0QT", first word of a snapshot file
+		static const uint SNAPSHOT_VERSION = 1; //layout of the snapshot files this code writes
+
+	private:
+		uint m_uMaxLevel = 3; //will store the maximum level an octant can go to
+		uint m_uIdealEntityCount = 5; //will tell how many ideal entities this object will contain
+		uint m_uFlags = OCTANT_DEFAULT; //will store the eOctantFlags the tree is built with
 
 		MeshManager* m_pMeshMngr = nullptr; //mesh manager singleton
 		MyEntityManager* m_pEntityMngr = nullptr; //entity manager singleton
 
-		vector3 m_v3Center = vector3(0.0f); //will store the center point of the octant
-		vector3 m_v3Min = vector3(0.0f); //will store the minimum vector of the octant
-		vector3 m_v3Max = vector3(0.0f); //will store the maximum vector of the octant
+		std::vector<MyOctantNode> m_lNode; //every node of the tree in breadth first (morton key) order, the root is index 0
+		std::vector<uint> m_lChild; //list of the nodes that contain objects (leafs, or any node in a loose tree)
+		std::vector<uint> m_lFreeBlock[CHILD_COUNT]; //first index of the blocks of released nodes, sorted by block size minus one
+		std::vector<uint> m_lEntity; //entity ranges of every node back to back (compressed sparse row), leafs in leaf list order after a compaction
+		uint m_uEntityGarbage = 0; //slots of the entity array no node owns since the last compaction
+		std::vector<uint> m_lMerge; //entities of a node and its children while they are merged
 
-		MyOctant* m_pParent = nullptr; //will store the parent of the current octant
-		MyOctant* m_pChild[8]; //will store the children of the current octant
+		std::vector<vector3> m_lEntityMin; //minimum of each entity's proxy box at the time of the build
+		std::vector<vector3> m_lEntityMax; //maximum of each entity's proxy box at the time of the build
+		std::vector<uint> m_lMoved; //entities whose bounds changed since the last update
+		std::vector<uint> m_lOldLeaf; //leafs an entity was in before moving
+		std::vector<uint> m_lNewLeaf; //leafs an entity is in after moving
+		std::vector<uint> m_lGrown; //leafs that received entities during an update
+		std::vector<uint> m_lShrunk; //leafs that lost entities during an update
 
-		std::vector<uint> m_EntityList; //list of entities under this octant (index in entity manager)
+		std::vector<uint> m_lQueryMark; //stamp of the last query that reported each entity
+		uint m_uQueryStamp = 0; //stamp of the query running
+		std::vector<std::pair<float, uint>> m_lQueryNode; //nodes a nearest query has yet to visit with their distance
+		std::vector<std::pair<float, uint>> m_lQueryHit; //entities a ray or nearest query found with their distance
 
-		MyOctant* m_pRoot = nullptr; //root octant
-		std::vector<MyOctant*> m_lChild; //list of nodes that contain objects (this will be applied to root only)
+		MyOctantStats m_Stats; //measurements of the tree
+		std::vector<uint> m_lStatCount; //leafs listing each entity while the stats are counted
 
 	public:
 		/*
@@ -37,69 +174,107 @@ namespace Simplex
 		manager currently contains
 		ARGUMENTS:
 		- uint a_nMaxLevel = 2 -> sets the maximum level of subdivision
-		- uint nIdealEntityCount = 5 -> sets the ideal level of objects per octant
+		- uint nIdealEntityCount = 5 -> sets the ideal level of objects per octant (unused by OCTANT_ADAPTIVE)
+		- uint a_uFlags = OCTANT_DEFAULT -> eOctantFlags to build the tree with
 		OUTPUT: class object
 		*/
-		MyOctant(uint a_nMaxLevel = 2, uint a_nIdealEntityCount = 5);
+		MySpatialTree(uint a_nMaxLevel = 2, uint a_nIdealEntityCount = 5, uint a_uFlags = OCTANT_DEFAULT);
 		/*
-		USAGE: Constructor
+		USAGE: Constructor, builds the tree over a copy of the entity bounds without touching the entity
+		manager so it can run on a worker thread; AssignIDtoEntity has to be called on the main thread
+		before the dimensions of the entities are used
 		ARGUMENTS:
-		- vector3 a_v3Center -> center of the octant in global space
-		- float a_fSize -> size of each side of the octant volume
+		- std::vector<vector3> const& a_lEntityMin -> minimum of the proxy box of each entity
+		- std::vector<vector3> const& a_lEntityMax -> maximum of the proxy box of each entity
+		- uint a_nMaxLevel -> sets the maximum level of subdivision
+		- uint a_nIdealEntityCount -> sets the ideal level of objects per octant
+		- uint a_uFlags -> eOctantFlags to build the tree with
 		OUTPUT: class object
 		*/
-		MyOctant(vector3 a_v3Center, float a_fSize);
+		MySpatialTree(std::vector<vector3> const& a_lEntityMin, std::vector<vector3> const& a_lEntityMax, uint a_nMaxLevel, uint a_nIdealEntityCount, uint a_uFlags);
+		/*
+		USAGE: Constructor, loads the tree from a snapshot file when it was written with the same settings
+		over the same entity bounds, otherwise builds the tree and writes the file for the next start
+		ARGUMENTS:
+		- String a_sFileName -> path of the snapshot file
+		- uint a_nMaxLevel -> sets the maximum level of subdivision
+		- uint a_nIdealEntityCount -> sets the ideal level of objects per octant
+		- uint a_uFlags -> eOctantFlags to build the tree with
+		OUTPUT: class object
+		*/
+		MySpatialTree(String a_sFileName, uint a_nMaxLevel, uint a_nIdealEntityCount, uint a_uFlags);
 		/*
 		USAGE: Copy constructor
 		ARGUMENTS: class object to copy
 		OUTPUT: class object instance
 		*/
-		MyOctant(MyOctant const& other);
+		MySpatialTree(MySpatialTree const& other);
 		/*
 		USAGE: Copy assignment constructor
 		ARGUMENTS: class object to copy
 		OUTPUT: ---
 		*/
-		MyOctant& operator=(MyOctant const& other);
+		MySpatialTree& operator=(MySpatialTree const& other);
 		/*
 		USAGE: Destructor
 		ARGUMENTS: ---
 		OUTPUT: ---
 		*/
-		~MyOctant();
+		~MySpatialTree();
 		/*
 		USAGE: Changes object contents for other object's
 		ARGUMENTS:
-		- MyOctant& other -> object to swap content from
+		- MySpatialTree& other -> object to swap content from
 		OUTPUT: ---
 		*/
-		void Swap(MyOctant& other);
+		void Swap(MySpatialTree& other);
 		/*
-		USAGE: Gets this octant's size
+		USAGE: Gets the size of the root octant
 		ARGUMENTS: ---
 		OUTPUT: size of octant
 		*/
 		float GetSize();
 		/*
-		USAGE: Gets the center of the octant in global space
+		USAGE: Gets the center of the root octant in global space
 		ARGUMENTS: ---
 		OUTPUT: Center of the octant in global space
 		*/
 		vector3 GetCenterGlobal();
 		/*
-		USAGE: Gets the min corner of the octant in global space
+		USAGE: Gets the min corner of the root octant in global space
 		ARGUMENTS: ---
 		OUTPUT: Minimum in global space
 		*/
 		vector3 GetMinGlobal();
 		/*
-		USAGE: Gets the max corner of the octant in global space
+		USAGE: Gets the max corner of the root octant in global space
 		ARGUMENTS: ---
 		OUTPUT: Maximum in global space
 		*/
 		vector3 GetMaxGlobal();
 		/*
-		USAGE: Asks if there is a collision with the entity specified by index from
+		USAGE: Gets the node stored at the index
+		ARGUMENTS:
+		- uint a_uNode -> index of the node
+		OUTPUT: node, nullptr if the index is out of range
+		*/
+		MyOctantNode const* GetNode(uint a_uNode);
+		/*
+		USAGE: Gets the entities of a node, valid until the tree is updated or built again
+		ARGUMENTS:
+		- uint a_uNode -> index of the node
+		OUTPUT: first of the m_uEntityCount entity indices of the node, nullptr if the index is out of range
+		*/
+		uint const* GetEntityList(uint a_uNode);
+		/*
+		USAGE: Finds the node addressed by a morton locational code by descending from the root
+		ARGUMENTS:
+		- uint a_uKey -> locational code of the node (1 is the root)
+		OUTPUT: index of the node, INVALID_NODE if the tree is not that deep there
+		*/
+		uint GetNodeIndex(uint a_uKey);
+		/*
+		USAGE: Asks if there is a collision between the root octant and the entity specified by index from
 		the bounding object manager
 		ARGUMENTS:
 		- int a_URBIndex -> Index of the entity in the entity manager
@@ -107,7 +282,16 @@ namespace Simplex
 		*/
 		bool IsColliding(uint a_uRBIndex);
 		/*
-		USAGE: Displays the MyOctant volume specified by index including the objects underneath
+		USAGE: Asks if there is a collision between a node and the entity specified by index from
+		the bounding object manager
+		ARGUMENTS:
+		- uint a_uNode -> index of the node
+		- int a_URBIndex -> Index of the entity in the entity manager
+		OUTPUT: check of the collision
+		*/
+		bool IsColliding(uint a_uNode, uint a_uRBIndex);
+		/*
+		USAGE: Displays the MyOctant volume specified by index
 		ARGUMENTS:
 		- uint a_nIndex -> MyOctant to be displayed
 		- vector3 a_v3Color = C_YELLOW -> color of the volume to display
@@ -115,12 +299,18 @@ namespace Simplex
 		*/
 		void Display(uint a_nIndex, vector3 a_v3Color = C_YELLOW);
 		/*
-		USAGE: Displays the MyOctant volume in the color specified
+		USAGE: Displays every MyOctant volume in the color specified
 		ARGUMENTS:
 		- vector3 a_v3Color = C_YELLOW -> color of the volume to display
 		OUTPUT: ---
 		*/
-		void Display(vector3 a_v3Color = C_YELLOW);
+		virtual void Display(vector3 a_v3Color = C_YELLOW) override;
+		/*
+		USAGE: Gets the memory the tree holds on to, the capacity of its arrays included
+		ARGUMENTS: ---
+		OUTPUT: bytes
+		*/
+		virtual size_t GetMemoryUsage() override;
 		/*
 		USAGE: Displays the non empty leafs in the octree
 		ARGUMENTS:
@@ -135,38 +325,44 @@ namespace Simplex
 		*/
 		void ClearEntityList();
 		/*
-		USAGE: allocates 8 smaller octants in the child pointers
-		ARGUMENTS: ---
+		USAGE: creates the CHILD_COUNT smaller octants of a node in a free block or at the end of the node array
+		ARGUMENTS:
+		- uint a_uNode -> index of the node to subdivide
 		OUTPUT: ---
 		*/
-		void Subdivide();
+		void Subdivide(uint a_uNode);
 		/*
-		USAGE: returns the child specified in the index
-		ARGUMENTS: uint a_nChild -> index of the child (from 0 to 7)
-		OUTPUT: MyOctant object (child in index)
+		USAGE: returns the index of the child of a node
+		ARGUMENTS:
+		- uint a_uNode -> index of the node
+		- uint a_nChild -> morton index of the child (from 0 to CHILD_COUNT - 1, bit 0 is +x, then +y and +z in an octree or +z in a quadtree)
+		OUTPUT: index of the child, INVALID_NODE if it does not exist
 		*/
-		MyOctant* GetChild(uint a_nChild);
+		uint GetChild(uint a_uNode, uint a_nChild);
 		/*
-		USAGE: returns the parent of the octant
-		ARGUMENTS: ---
-		OUTPUT: MyOctant object (parent)
+		USAGE: returns the index of the parent of a node
+		ARGUMENTS:
+		- uint a_uNode -> index of the node
+		OUTPUT: index of the parent, INVALID_NODE for the root
 		*/
-		MyOctant* GetParent();
+		uint GetParent(uint a_uNode);
 		/*
-		USAGE: Asks the MyOctant if it does not contain any children (its a leaf)
-		ARGUMENTS: ---
+		USAGE: Asks if the node does not contain any children (its a leaf)
+		ARGUMENTS:
+		- uint a_uNode -> index of the node
 		OUTPUT: It contains no children
 		*/
-		bool IsLeaf();
+		bool IsLeaf(uint a_uNode);
 		/*
-		USAGE: Asks the MyOctant if it contains more than this many bounding objects
+		USAGE: Asks the node if it contains more than this many bounding objects
 		ARGUMENTS:
+		- uint a_uNode -> index of the node
 		- uint a_nEntities -> number of entities to query
 		OUTPUT: It contains at least this many entities
 		*/
-		bool ContainsMoreThan(uint a_nEntities);
+		bool ContainsMoreThan(uint a_uNode, uint a_nEntities);
 		/*
-		USAGE: Deletes all children and the children of their children
+		USAGE: Deletes every node but the root
 		ARGUMENTS: ---
 		OUTPUT: ---
 		*/
@@ -179,17 +375,182 @@ namespace Simplex
 		*/
 		void ConstructTree(uint a_nMaxLevel = 3);
 		/*
-		USAGE: Traverse the tree up to leafs and sets the objects in them to the index
+		USAGE: Sets the entities in the leafs to the index of the leaf; in a loose tree each entity gets
+		only the node holding it, so pairs have to come from GetCandidatePairs instead of SharesDimension;
+		does nothing in an OCTANT_DETACHED tree
 		ARGUMENTS: ---
 		OUTPUT: ---
 		*/
 		void AssignIDtoEntity();
 		/*
-		USAGE: Gets the total number of octants in the world
+		USAGE: Writes the nodes, leaf list and free blocks of the tree to a binary file, with a hash of
+		the entity bounds the tree was built over
+		ARGUMENTS:
+		- String a_sFileName -> path of the file
+		OUTPUT: the file was written
+		*/
+		bool SaveSnapshot(String a_sFileName);
+		/*
+		USAGE: Replaces the tree with the one in a snapshot file if the file was written with the settings
+		of this tree over the current entity bounds, and assigns the dimensions of the entities again; the
+		file is read whole, every record is checked and then copied in to the arrays of the tree
+		ARGUMENTS:
+		- String a_sFileName -> path of the file
+		OUTPUT: the tree was replaced, the tree is left as it was otherwise
+		*/
+		bool LoadSnapshot(String a_sFileName);
+		/*
+		USAGE: Moves the entities whose bounds changed out of the leafs they left and in to the leafs
+		they entered, then splits the leafs that grew too big and collapses the nodes that became too
+		small; if an entity left the root or entities were removed the tree is rebuilt
+		ARGUMENTS:
+		- std::vector<uint> const& a_lEntity -> indices of the entities that moved since the last update
+		OUTPUT: ---
+		*/
+		void UpdateEntities(std::vector<uint> const& a_lEntity);
+		/*
+		USAGE: Finds the entities whose proxy boxes changed since the last update (or were added
+		since the last build) and updates only those
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		virtual void UpdateEntities() override;
+		/*
+		USAGE: Finds the leafs a box overlaps
+		ARGUMENTS:
+		- vector3 a_v3Min -> minimum of the box in global space
+		- vector3 a_v3Max -> maximum of the box in global space
+		- std::vector<uint>& a_lLeaf -> output, indices of the leafs
+		OUTPUT: ---
+		*/
+		void FindLeafs(vector3 a_v3Min, vector3 a_v3Max, std::vector<uint>& a_lLeaf);
+		/*
+		USAGE: Finds the leaf a point falls in, points on a splitting plane belong to the lower child
+		ARGUMENTS:
+		- vector3 a_v3Point -> point in global space
+		OUTPUT: index of the leaf, INVALID_NODE if the point falls in an octant a sparse tree did not create
+		*/
+		uint FindLeaf(vector3 a_v3Point);
+		/*
+		USAGE: Asks if FindLeaf would answer a leaf for a point, using only the bounds of the leaf; the
+		bounds of a leaf are the splitting planes of its ancestors, and a point past the root belongs to
+		the leafs on that side of the root
+		ARGUMENTS:
+		- uint a_uLeaf -> index of the leaf
+		- vector3 a_v3Point -> point in global space
+		OUTPUT: the point falls in the leaf
+		*/
+		bool HoldsPoint(uint a_uLeaf, vector3 a_v3Point);
+		/*
+		USAGE: Walks the non empty leafs and lists every pair of entities that share a leaf and
+		whose bounds overlap; a pair sharing several leafs is only listed by the leaf that holds
+		the minimum corner of the overlap of both bounds. A loose tree checks every entity against
+		the nodes whose loose bounds it overlaps instead
+		ARGUMENTS:
+		- std::vector<std::pair<uint, uint>>& a_lPair -> output, pairs of entity indices (lower index first)
+		OUTPUT: ---
+		*/
+		virtual void GetCandidatePairs(std::vector<std::pair<uint, uint>>& a_lPair) override;
+		/*
+		USAGE: Finds the entities whose bounds overlap a box; like every query it uses the entity bounds
+		of the last build or update and keeps its work arrays between calls so it does not allocate
+		ARGUMENTS:
+		- vector3 a_v3Min -> minimum of the box in global space
+		- vector3 a_v3Max -> maximum of the box in global space
+		- std::vector<uint>& a_lEntity -> output, indices of the entities
+		OUTPUT: ---
+		*/
+		void QueryBox(vector3 a_v3Min, vector3 a_v3Max, std::vector<uint>& a_lEntity);
+		/*
+		USAGE: Finds the entities whose bounds overlap a sphere
+		ARGUMENTS:
+		- vector3 a_v3Center -> center of the sphere in global space
+		- float a_fRadius -> radius of the sphere
+		- std::vector<uint>& a_lEntity -> output, indices of the entities
+		OUTPUT: ---
+		*/
+		void QuerySphere(vector3 a_v3Center, float a_fRadius, std::vector<uint>& a_lEntity);
+		/*
+		USAGE: Finds the entities whose bounds are at least partly inside the view frustum of a camera
+		ARGUMENTS:
+		- matrix4 a_m4ViewProjection -> projection matrix times view matrix of the camera
+		- std::vector<uint>& a_lEntity -> output, indices of the entities
+		OUTPUT: ---
+		*/
+		void QueryFrustum(matrix4 a_m4ViewProjection, std::vector<uint>& a_lEntity);
+		/*
+		USAGE: Finds the entities whose bounds overlap a volume
+		ARGUMENTS:
+		- MyOctantQuery const& a_Query -> volume to look in
+		- std::vector<uint>& a_lEntity -> output, indices of the entities
+		OUTPUT: ---
+		*/
+		void QueryVolume(MyOctantQuery const& a_Query, std::vector<uint>& a_lEntity);
+		/*
+		USAGE: Finds the closest entity whose bounds a ray hits
+		ARGUMENTS:
+		- vector3 a_v3Origin -> start of the ray in global space
+		- vector3 a_v3Direction -> direction of the ray
+		- uint& a_uEntity -> output, index of the entity
+		- float& a_fDistance -> output, distance from the origin to the hit
+		OUTPUT: the ray hit an entity
+		*/
+		bool RaycastFirst(vector3 a_v3Origin, vector3 a_v3Direction, uint& a_uEntity, float& a_fDistance);
+		/*
+		USAGE: Finds every entity whose bounds a ray hits
+		ARGUMENTS:
+		- vector3 a_v3Origin -> start of the ray in global space
+		- vector3 a_v3Direction -> direction of the ray
+		- std::vector<uint>& a_lEntity -> output, indices of the entities from the closest to the farthest
+		OUTPUT: ---
+		*/
+		void RaycastAll(vector3 a_v3Origin, vector3 a_v3Direction, std::vector<uint>& a_lEntity);
+		/*
+		USAGE: Finds the entities whose bounds are the closest to a point
+		ARGUMENTS:
+		- vector3 a_v3Point -> point in global space
+		- uint a_uCount -> number of entities to find
+		- std::vector<uint>& a_lEntity -> output, indices of the entities from the closest to the farthest
+		OUTPUT: ---
+		*/
+		void QueryNearest(vector3 a_v3Point, uint a_uCount, std::vector<uint>& a_lEntity);
+		/*
+		USAGE: Gets the total number of octants in the tree
 		ARGUMENTS: ---
 		OUTPUT: ---
 		*/
 		uint GetOctantCount();
+		/*
+		USAGE: Gets the list of the nodes that contain objects
+		ARGUMENTS: ---
+		OUTPUT: indices of the non empty leafs (of every non empty node in a loose tree)
+		*/
+		std::vector<uint> const& GetLeafList();
+		/*
+		USAGE: Counts the nodes, leaf occupancy and straddlers of the tree and returns them with the
+		times and pair counts recorded by the last build, update and GetCandidatePairs
+		ARGUMENTS: ---
+		OUTPUT: measurements of the tree
+		*/
+		MyOctantStats const& GetStats();
+		/*
+		USAGE: Gets the maximum level of the tree
+		ARGUMENTS: ---
+		OUTPUT: maximum level
+		*/
+		uint GetMaxLevel();
+		/*
+		USAGE: Gets the ideal entity count of the tree
+		ARGUMENTS: ---
+		OUTPUT: ideal entity count
+		*/
+		uint GetIdealEntityCount();
+		/*
+		USAGE: Gets the eOctantFlags the tree was built with
+		ARGUMENTS: ---
+		OUTPUT: flags
+		*/
+		uint GetFlags();
 
 	private:
 		/*
@@ -210,6 +571,389 @@ namespace Simplex
 		OUTPUT: ---
 		*/
 		void ConstructList();
+		/*
+		USAGE: Asks if a box overlaps the volume of a node
+		ARGUMENTS:
+		- uint a_uNode -> index of the node
+		- vector3 a_v3Min -> minimum of the box in global space
+		- vector3 a_v3Max -> maximum of the box in global space
+		OUTPUT: check of the collision
+		*/
+		bool IsColliding(uint a_uNode, vector3 a_v3Min, vector3 a_v3Max);
+		/*
+		USAGE: Gets the bounds a query has to touch for a node or its children to hold anything it looks
+		for, the loose bounds in a loose tree
+		ARGUMENTS:
+		- uint a_uNode -> index of the node
+		- vector3& a_v3Min -> output, minimum of the bounds
+		- vector3& a_v3Max -> output, maximum of the bounds
+		OUTPUT: ---
+		*/
+		void GetQueryBounds(uint a_uNode, vector3& a_v3Min, vector3& a_v3Max);
+		/*
+		USAGE: Starts a query, no entity is marked as reported after this
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void BeginQuery();
+		/*
+		USAGE: Marks an entity as reported by the query running
+		ARGUMENTS:
+		- uint a_uEntity -> index of the entity
+		OUTPUT: the entity was not reported before
+		*/
+		bool MarkEntity(uint a_uEntity);
+		/*
+		USAGE: Asks if a box is at least partly inside a query volume
+		ARGUMENTS:
+		- MyOctantQuery const& a_Query -> volume
+		- vector3 a_v3Min -> minimum of the box in global space
+		- vector3 a_v3Max -> maximum of the box in global space
+		OUTPUT: the box touches the volume
+		*/
+		static bool IsTouching(MyOctantQuery const& a_Query, vector3 a_v3Min, vector3 a_v3Max);
+		/*
+		USAGE: Finds where a ray enters a box
+		ARGUMENTS:
+		- vector3 a_v3Origin -> start of the ray
+		- vector3 a_v3InverseDirection -> one over each component of the normalized direction of the ray
+		- vector3 a_v3Min -> minimum of the box
+		- vector3 a_v3Max -> maximum of the box
+		- float& a_fDistance -> output, distance from the origin to the box (0 if the origin is inside)
+		OUTPUT: the ray hits the box
+		*/
+		static bool IntersectRay(vector3 a_v3Origin, vector3 a_v3InverseDirection, vector3 a_v3Min, vector3 a_v3Max, float& a_fDistance);
+		/*
+		USAGE: Gets the squared distance from a point to the closest point of a box
+		ARGUMENTS:
+		- vector3 a_v3Point -> point
+		- vector3 a_v3Min -> minimum of the box
+		- vector3 a_v3Max -> maximum of the box
+		OUTPUT: squared distance, 0 if the point is inside
+		*/
+		static float GetDistanceSquared(vector3 a_v3Point, vector3 a_v3Min, vector3 a_v3Max);
+		/*
+		USAGE: Asks if a box overlaps the loose bounds of a node (twice the size of the node)
+		ARGUMENTS:
+		- uint a_uNode -> index of the node
+		- vector3 a_v3Min -> minimum of the box in global space
+		- vector3 a_v3Max -> maximum of the box in global space
+		OUTPUT: check of the collision
+		*/
+		bool IsCollidingLoose(uint a_uNode, vector3 a_v3Min, vector3 a_v3Max);
+		/*
+		USAGE: Gets the loose bounds of a node, twice its size on the split axes and the bounds of the
+		node on the axis a quadtree does not split
+		ARGUMENTS:
+		- MyOctantNode const& a_Node -> node
+		- vector3& a_v3Min -> output, minimum of the loose bounds
+		- vector3& a_v3Max -> output, maximum of the loose bounds
+		OUTPUT: ---
+		*/
+		static void GetLooseBounds(MyOctantNode const& a_Node, vector3& a_v3Min, vector3& a_v3Max);
+		/*
+		USAGE: Finds the deepest existing node whose loose bounds contain a box
+		ARGUMENTS:
+		- vector3 a_v3Min -> minimum of the box in global space
+		- vector3 a_v3Max -> maximum of the box in global space
+		OUTPUT: index of the node
+		*/
+		uint FindLooseNode(vector3 a_v3Min, vector3 a_v3Max);
+		/*
+		USAGE: Finds the nodes that hold an entity with the given bounds, the leafs it overlaps or the
+		node it fits in for a loose tree
+		ARGUMENTS:
+		- vector3 a_v3Min -> minimum of the bounds in global space
+		- vector3 a_v3Max -> maximum of the bounds in global space
+		- std::vector<uint>& a_lNode -> output, indices of the nodes
+		OUTPUT: ---
+		*/
+		void FindEntityNodes(vector3 a_v3Min, vector3 a_v3Max, std::vector<uint>& a_lNode);
+		/*
+		USAGE: Lists the pairs of a loose tree, each entity looks for the entities with a higher index
+		in the nodes whose loose bounds its bounds overlap
+		ARGUMENTS:
+		- std::vector<std::pair<uint, uint>>& a_lPair -> output, pairs of entity indices (lower index first)
+		OUTPUT: ---
+		*/
+		void GetLooseCandidatePairs(std::vector<std::pair<uint, uint>>& a_lPair);
+		/*
+		USAGE: Lists the pairs of a tree that keeps the entities in the leafs, a pair is reported by the
+		leaf holding the minimum corner of the overlap of the two bounds
+		ARGUMENTS:
+		- std::vector<std::pair<uint, uint>>& a_lPair -> output, pairs of entity indices (lower index first)
+		OUTPUT: ---
+		*/
+		void GetLeafCandidatePairs(std::vector<std::pair<uint, uint>>& a_lPair);
+		/*
+		USAGE: Measures the time since a point in time
+		ARGUMENTS:
+		- std::chrono::high_resolution_clock::time_point a_Start -> point in time
+		OUTPUT: milliseconds since a_Start
+		*/
+		static float GetMillisecondsSince(std::chrono::high_resolution_clock::time_point a_Start);
+		/*
+		USAGE: Subdivides the nodes of a branch breadth first, handing the entities of each subdivided
+		node to its children in a single pass over the node's range of the index array
+		ARGUMENTS:
+		- MyOctantBranch& a_Branch -> branch to build, its root and the root's range must be set
+		- uint a_uStopLevel -> nodes at this level that need subdividing are left for later
+		- std::vector<uint>* a_pPending = nullptr -> output, nodes that were left for later
+		OUTPUT: ---
+		*/
+		void BuildBranch(MyOctantBranch& a_Branch, uint a_uStopLevel, std::vector<uint>* a_pPending = nullptr);
+		/*
+		USAGE: Builds the branches under the pending nodes on the shared MyWorkerPool and appends them to the
+		node array in the order of the pending list so the octant IDs do not depend on timing
+		ARGUMENTS:
+		- MyOctantBranch& a_Top -> branch holding the ranges of the pending nodes
+		- std::vector<uint> const& a_lPending -> nodes whose branches are left to build
+		OUTPUT: ---
+		*/
+		void BuildBranchesInParallel(MyOctantBranch& a_Top, std::vector<uint> const& a_lPending);
+		/*
+		USAGE: Hands the entities of a node to its children in a single pass, writing the range of each
+		child at the end of the index array and setting the child mask of the node (only the children
+		that receive entities in a sparse tree)
+		ARGUMENTS:
+		- MyOctantBranch& a_Branch -> branch the node belongs to
+		- uint a_uNode -> index of the node in the branch
+		OUTPUT: the entities were handed down, false if an adaptive tree found the split does not pay
+		*/
+		bool PartitionEntities(MyOctantBranch& a_Branch, uint a_uNode);
+		/*
+		USAGE: Asks if splitting a node lowers the pair tests; an adaptive tree compares the pairs of the
+		node with the pairs of its children (straddlers counted in every child they reach) plus what
+		the children cost, otherwise the ideal entity count decides
+		ARGUMENTS:
+		- uint a_uCount -> entities in the node
+		- uint a_uStayCount -> entities that would stay in the node (loose tree)
+		- uint const* a_pChildCount -> entities each of the CHILD_COUNT children would get
+		OUTPUT: the node should be split
+		*/
+		bool ShouldSplit(uint a_uCount, uint a_uStayCount, uint const* a_pChildCount);
+		/*
+		USAGE: Gets the entity count a node has to go over to be considered for a split
+		ARGUMENTS: ---
+		OUTPUT: 1 for an adaptive tree (a single entity has no pairs), the ideal entity count otherwise
+		*/
+		uint GetSplitCount();
+		/*
+		USAGE: Fills the children set in the child mask of a node in morton order
+		ARGUMENTS:
+		- MyOctantNode const& a_Parent -> node being subdivided, its child mask must be set
+		- uint a_uParent -> index of the node being subdivided
+		- MyOctantNode* a_pChild -> output, one node per bit of the child mask
+		OUTPUT: ---
+		*/
+		static void MakeChildren(MyOctantNode const& a_Parent, uint a_uParent, MyOctantNode* a_pChild);
+		/*
+		USAGE: Gets which octants of a node a box overlaps, whether they were created or not
+		ARGUMENTS:
+		- MyOctantNode const& a_Parent -> node to split, the splitting planes go through its center
+		- vector3 a_v3Min -> minimum of the box in global space
+		- vector3 a_v3Max -> maximum of the box in global space
+		OUTPUT: mask with a bit set for each overlapped octant (in morton order)
+		*/
+		static uint GetChildMask(MyOctantNode const& a_Parent, vector3 a_v3Min, vector3 a_v3Max);
+		/*
+		USAGE: Gets the child of a node whose loose bounds contain a box, picked by the center of the box
+		ARGUMENTS:
+		- MyOctantNode const& a_Parent -> node to split
+		- vector3 a_v3Min -> minimum of the box in global space
+		- vector3 a_v3Max -> maximum of the box in global space
+		OUTPUT: morton index of the child, CHILD_COUNT if the box does not fit in any child
+		*/
+		static uint GetLooseChild(MyOctantNode const& a_Parent, vector3 a_v3Min, vector3 a_v3Max);
+		/*
+		USAGE: Gets the children of a node an entity is handed to, the ones its bounds overlap or, in a
+		loose tree, the one it fits in
+		ARGUMENTS:
+		- MyOctantNode const& a_Parent -> node to split
+		- uint a_uEntity -> index of the entity
+		OUTPUT: mask with a bit set for each child (in morton order), 0 if the entity stays in the node
+		*/
+		uint GetEntityChildMask(MyOctantNode const& a_Parent, uint a_uEntity);
+		/*
+		USAGE: Counts the children stored before the child with the given morton index
+		ARGUMENTS:
+		- uint a_uChildMask -> child mask of the node
+		- uint a_nChild -> morton index of the child
+		OUTPUT: offset of the child from the first child
+		*/
+		static constexpr uint GetChildOffset(uint a_uChildMask, uint a_nChild)
+		{
+			uint offset = 0;
+			for(uint i = 0; i < a_nChild; i++)
+			{
+				offset += (a_uChildMask >> i) & 1;
+			}
+			return offset;
+		}
+		/*
+		USAGE: Gets the axis a bit of the morton index of a child picks the half of
+		ARGUMENTS:
+		- uint a_uBit -> bit of the morton index (from 0 to Dimension - 1)
+		OUTPUT: 0 for x, 1 for y and 2 for z; a quadtree uses x and z
+		*/
+		static constexpr uint GetChildAxis(uint a_uBit)
+		{
+			return Dimension == 3 ? a_uBit : a_uBit * 2;
+		}
+		/*
+		USAGE: Gets the children on the upper half of the axis of a bit of the morton index
+		ARGUMENTS:
+		- uint a_uBit -> bit of the morton index (from 0 to Dimension - 1)
+		OUTPUT: mask with a bit set for each child whose morton index has a_uBit set
+		*/
+		static constexpr uint GetUpperChildMask(uint a_uBit)
+		{
+			uint mask = 0;
+			for(uint i = 0; i < CHILD_COUNT; i++)
+			{
+				mask |= ((i >> a_uBit) & 1) << i;
+			}
+			return mask;
+		}
+		/*
+		USAGE: Takes a block of consecutive nodes from the free blocks of that size or from the end of the array
+		ARGUMENTS:
+		- uint a_uCount -> number of nodes in the block (from 1 to CHILD_COUNT)
+		OUTPUT: index of the first node of the block
+		*/
+		uint AllocateBlock(uint a_uCount);
+		/*
+		USAGE: Marks a block of nodes as released so it can be reused
+		ARGUMENTS:
+		- uint a_uFirst -> index of the first node of the block
+		- uint a_uCount -> number of nodes in the block (from 1 to CHILD_COUNT)
+		OUTPUT: ---
+		*/
+		void ReleaseBlock(uint a_uFirst, uint a_uCount);
+		/*
+		USAGE: Adds a node to the dimensions of an entity unless the tree is OCTANT_DETACHED
+		ARGUMENTS:
+		- uint a_uEntity -> index of the entity
+		- uint a_uNode -> index of the node
+		OUTPUT: ---
+		*/
+		void AddEntityDimension(uint a_uEntity, uint a_uNode);
+		/*
+		USAGE: Removes a node from the dimensions of an entity unless the tree is OCTANT_DETACHED
+		ARGUMENTS:
+		- uint a_uEntity -> index of the entity
+		- uint a_uNode -> index of the node
+		OUTPUT: ---
+		*/
+		void RemoveEntityDimension(uint a_uEntity, uint a_uNode);
+		/*
+		USAGE: Makes room in the range of a node, moving the range to the end of the entity array with
+		at least twice its capacity when it is full; the slots left behind are garbage until the next compaction
+		ARGUMENTS:
+		- uint a_uNode -> index of the node
+		- uint a_uCount -> number of entities the range has to hold
+		OUTPUT: ---
+		*/
+		void ReserveEntities(uint a_uNode, uint a_uCount);
+		/*
+		USAGE: Adds an entity at the end of the range of a node
+		ARGUMENTS:
+		- uint a_uNode -> index of the node
+		- uint a_uEntity -> index of the entity
+		OUTPUT: ---
+		*/
+		void PushEntity(uint a_uNode, uint a_uEntity);
+		/*
+		USAGE: Removes an entity from the range of a node by moving the last entity of the range in its place
+		ARGUMENTS:
+		- uint a_uNode -> index of the node
+		- uint a_uEntity -> index of the entity
+		OUTPUT: ---
+		*/
+		void EraseEntity(uint a_uNode, uint a_uEntity);
+		/*
+		USAGE: Empties the range of a node and gives its slots up as garbage
+		ARGUMENTS:
+		- uint a_uNode -> index of the node
+		OUTPUT: ---
+		*/
+		void ReleaseEntities(uint a_uNode);
+		/*
+		USAGE: Rebuilds the entity array in a counting pass, laying the ranges of the nodes back to back
+		with no slack, the leafs first in leaf list order so the pairs are listed in one sweep
+		ARGUMENTS:
+		- std::vector<uint> const& a_lSource -> array the ranges of the nodes point in to now
+		OUTPUT: ---
+		*/
+		void CompactEntities(std::vector<uint> const& a_lSource);
+		/*
+		USAGE: Creates the octants of a sparse tree a box reaches but that were not created yet, the
+		children of a node that gains a child are moved to a new block
+		ARGUMENTS:
+		- vector3 a_v3Min -> minimum of the box in global space
+		- vector3 a_v3Max -> maximum of the box in global space
+		OUTPUT: nodes were moved
+		*/
+		bool AddMissingChildren(vector3 a_v3Min, vector3 a_v3Max);
+		/*
+		USAGE: Moves the children of a node to a new block holding the children of a new child mask,
+		keeping the entities and dimensions of the moved nodes
+		ARGUMENTS:
+		- uint a_uNode -> index of the node
+		- uint a_uChildMask -> new child mask, must contain the current one
+		OUTPUT: ---
+		*/
+		void GrowChildren(uint a_uNode, uint a_uChildMask);
+		/*
+		USAGE: Sizes the root so it contains the copied bounds of every entity
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void FitRootToEntities();
+		/*
+		USAGE: Copies the proxy box of every entity from the entity manager
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void CopyEntityBounds();
+		/*
+		USAGE: Builds the tree under the root from the copied entity bounds, without assigning dimensions
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void BuildTree();
+		/*
+		USAGE: Hashes the bounds of every entity so a snapshot can tell if it was built over them
+		ARGUMENTS:
+		- std::vector<vector3> const& a_lEntityMin -> minimum of the proxy box of each entity
+		- std::vector<vector3> const& a_lEntityMax -> maximum of the proxy box of each entity
+		OUTPUT: 64 bit FNV-1a hash of the bounds
+		*/
+		static unsigned long long GetBoundsHash(std::vector<vector3> const& a_lEntityMin, std::vector<vector3> const& a_lEntityMax);
+		/*
+		USAGE: Subdivides a leaf and hands its entities to the new children
+		ARGUMENTS:
+		- uint a_uNode -> index of the leaf
+		OUTPUT: ---
+		*/
+		void SplitLeaf(uint a_uNode);
+		/*
+		USAGE: Asks if the children of a node are leafs holding, with the node, no more than the ideal
+		entity count
+		ARGUMENTS:
+		- uint a_uNode -> index of the node
+		OUTPUT: can be collapsed
+		*/
+		bool CanCollapse(uint a_uNode);
+		/*
+		USAGE: Moves the entities of the children of a node to the node and releases the children
+		ARGUMENTS:
+		- uint a_uNode -> index of the node
+		OUTPUT: ---
+		*/
+		void CollapseNode(uint a_uNode);
 	};
-}
 
+	typedef MySpatialTree<3, 10> MyOctant; //octree for entities spread through a volume
+	typedef MySpatialTree<2, 15> MyQuadtree; //quadtree for entities spread over the xz plane, like a ground grid
+}
@@ -0,0 +1,100 @@
+#include "MyOctantBuilder.h"
+using namespace Simplex;
+
+//Constructor building the first tree
+MyOctantBuilder::MyOctantBuilder(uint a_nMaxLevel, uint a_nIdealEntityCount, uint a_uFlags, String a_sSnapshot) : m_bReady(false)
+{
+	m_pEntityMngr = MyEntityManager::GetInstance();
+	m_uMaxLevel = a_nMaxLevel;
+	m_uIdealEntityCount = a_nIdealEntityCount;
+	m_uFlags = a_uFlags;
+	if(a_sSnapshot.empty())
+	{
+		m_pFront = new MyOctant(a_nMaxLevel, a_nIdealEntityCount, a_uFlags);
+	}
+	else
+	{
+		m_pFront = new MyOctant(a_sSnapshot, a_nMaxLevel, a_nIdealEntityCount, a_uFlags);
+	}
+}
+
+//Destructor for the builder
+MyOctantBuilder::~MyOctantBuilder()
+{
+	if(m_Worker.joinable())
+	{
+		m_Worker.join();
+	}
+	SafeDelete(m_pBack);
+	SafeDelete(m_pFront);
+}
+
+//Gets the tree in use
+MyOctant* MyOctantBuilder::GetTree()
+{
+	return m_pFront;
+}
+
+//Asks for a new tree
+void MyOctantBuilder::Rebuild(uint a_nMaxLevel, uint a_nIdealEntityCount, uint a_uFlags)
+{
+	m_uMaxLevel = a_nMaxLevel;
+	m_uIdealEntityCount = a_nIdealEntityCount;
+	m_uFlags = a_uFlags;
+	//Only the last settings asked for are built once the worker is free
+	if(m_Worker.joinable())
+	{
+		m_bPending = true;
+		return;
+	}
+	StartBuild();
+}
+
+//Checks if the worker is busy
+bool MyOctantBuilder::IsBuilding()
+{
+	return m_Worker.joinable();
+}
+
+//Swaps in the new tree if it is done
+bool MyOctantBuilder::Update()
+{
+	if(!m_bReady)
+	{
+		return false;
+	}
+	m_Worker.join();
+	m_bReady = false;
+	//The dimensions are shared by every entity, so they only change hands here on the main thread
+	if(!(m_pBack->GetFlags() & OCTANT_DETACHED))
+	{
+		m_pEntityMngr->ClearDimensionSetAll();
+	}
+	m_pBack->AssignIDtoEntity();
+	//The tree matches the bounds of when the build started, so the entities that moved since are refit
+	m_pBack->UpdateEntities();
+	std::swap(m_pFront, m_pBack);
+	SafeDelete(m_pBack);
+	if(m_bPending)
+	{
+		StartBuild();
+	}
+	return true;
+}
+
+//Starts the worker
+void MyOctantBuilder::StartBuild()
+{
+	m_bPending = false;
+	//Copies the bounds here so the worker never reads the entities while the frame moves them
+	m_lEntityMin = m_pEntityMngr->GetProxyMinList();
+	m_lEntityMax = m_pEntityMngr->GetProxyMaxList();
+	uint maxLevel = m_uMaxLevel;
+	uint idealEntityCount = m_uIdealEntityCount;
+	uint flags = m_uFlags;
+	m_Worker = std::thread([this, maxLevel, idealEntityCount, flags]()
+	{
+		m_pBack = new MyOctant(m_lEntityMin, m_lEntityMax, maxLevel, idealEntityCount, flags);
+		m_bReady = true;
+	});
+}
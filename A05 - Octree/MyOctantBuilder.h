@@ -0,0 +1,88 @@
+#pragma once
+
+#include "MyOctant.h"
+#include <thread>
+#include <atomic>
+
+namespace Simplex
+{
+	//Builds new octrees on a worker thread while the tree in use keeps answering queries, and swaps
+	//the finished tree in when asked at the frame boundary
+	class MyOctantBuilder
+	{
+		MyEntityManager* m_pEntityMngr = nullptr; //entity manager singleton
+
+		MyOctant* m_pFront = nullptr; //tree in use
+		MyOctant* m_pBack = nullptr; //tree being built, only the worker touches it until m_bReady is set
+		std::thread m_Worker; //thread building the back tree
+		std::atomic<bool> m_bReady; //the worker finished the back tree
+
+		bool m_bPending = false; //a rebuild was asked for while the worker was busy
+		uint m_uMaxLevel = 2; //maximum level of the next tree
+		uint m_uIdealEntityCount = 5; //ideal entity count of the next tree
+		uint m_uFlags = OCTANT_DEFAULT; //eOctantFlags of the next tree
+
+		std::vector<vector3> m_lEntityMin; //minimum of each entity's proxy box when the build started
+		std::vector<vector3> m_lEntityMax; //maximum of each entity's proxy box when the build started
+
+	public:
+		/*
+		USAGE: Constructor, builds the first tree on the calling thread
+		ARGUMENTS:
+		- uint a_nMaxLevel = 2 -> sets the maximum level of subdivision
+		- uint a_nIdealEntityCount = 5 -> sets the ideal level of objects per octant
+		- uint a_uFlags = OCTANT_DEFAULT -> eOctantFlags to build the tree with
+		- String a_sSnapshot = "" -> snapshot file the first tree is loaded from when it matches the
+		scene, and written to when it does not; no file is used when empty
+		OUTPUT: class object
+		*/
+		MyOctantBuilder(uint a_nMaxLevel = 2, uint a_nIdealEntityCount = 5, uint a_uFlags = OCTANT_DEFAULT, String a_sSnapshot = "");
+		/*
+		USAGE: Destructor, waits for the worker before releasing both trees
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		~MyOctantBuilder();
+		/*
+		USAGE: Gets the tree in use, the pointer changes when Update swaps in a new tree
+		ARGUMENTS: ---
+		OUTPUT: tree in use
+		*/
+		MyOctant* GetTree();
+		/*
+		USAGE: Starts building a new tree on the worker from a copy of the current entity bounds; if the
+		worker is busy the rebuild starts when the tree being built is swapped in
+		ARGUMENTS:
+		- uint a_nMaxLevel -> sets the maximum level of subdivision
+		- uint a_nIdealEntityCount -> sets the ideal level of objects per octant
+		- uint a_uFlags -> eOctantFlags to build the tree with
+		OUTPUT: ---
+		*/
+		void Rebuild(uint a_nMaxLevel, uint a_nIdealEntityCount, uint a_uFlags);
+		/*
+		USAGE: Asks if a tree is being built
+		ARGUMENTS: ---
+		OUTPUT: the worker is busy
+		*/
+		bool IsBuilding();
+		/*
+		USAGE: Call once per frame from the main thread; if the worker finished, hands the entity
+		dimensions to the new tree, catches it up with the entities that moved during the build and
+		makes it the tree in use
+		ARGUMENTS: ---
+		OUTPUT: a new tree was swapped in
+		*/
+		bool Update();
+
+	private:
+		/*
+		USAGE: Copies the entity bounds and starts the worker
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void StartBuild();
+
+		MyOctantBuilder(MyOctantBuilder const& other) = delete;
+		MyOctantBuilder& operator=(MyOctantBuilder const& other) = delete;
+	};
+}
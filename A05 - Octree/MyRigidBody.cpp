@@ -21,6 +21,11 @@ void MyRigidBody::Init(void)
 	m_v3MinG = ZERO_V3;
 	m_v3MaxG = ZERO_V3;
 
+	m_v3ProxyMin = ZERO_V3;
+	m_v3ProxyMax = ZERO_V3;
+	m_fProxyMargin = 0.0f;
+	m_fProxyVelocityScale = 0.0f;
+
 	m_v3HalfWidth = ZERO_V3;
 	m_v3ARBBSize = ZERO_V3;
 
@@ -49,6 +54,11 @@ void MyRigidBody::Swap(MyRigidBody& other)
 	std::swap(m_v3MinG, other.m_v3MinG);
 	std::swap(m_v3MaxG, other.m_v3MaxG);
 
+	std::swap(m_v3ProxyMin, other.m_v3ProxyMin);
+	std::swap(m_v3ProxyMax, other.m_v3ProxyMax);
+	std::swap(m_fProxyMargin, other.m_fProxyMargin);
+	std::swap(m_fProxyVelocityScale, other.m_fProxyVelocityScale);
+
 	std::swap(m_v3HalfWidth, other.m_v3HalfWidth);
 	std::swap(m_v3ARBBSize, other.m_v3ARBBSize);
 
@@ -80,6 +90,17 @@ vector3 MyRigidBody::GetMaxLocal(void) { return m_v3MaxL; }
 vector3 MyRigidBody::GetCenterGlobal(void){ return m_v3CenterG; }
 vector3 MyRigidBody::GetMinGlobal(void) { return m_v3MinG; }
 vector3 MyRigidBody::GetMaxGlobal(void) { return m_v3MaxG; }
+vector3 MyRigidBody::GetProxyMin(void) { return m_v3ProxyMin; }
+vector3 MyRigidBody::GetProxyMax(void) { return m_v3ProxyMax; }
+float MyRigidBody::GetProxyMargin(void) { return m_fProxyMargin; }
+void MyRigidBody::SetProxyMargin(float a_fMargin, float a_fVelocityScale)
+{
+	m_fProxyMargin = a_fMargin;
+	m_fProxyVelocityScale = a_fVelocityScale;
+	//force a refit with the new margin
+	m_v3ProxyMin = m_v3ProxyMax = m_v3CenterG;
+	UpdateProxy(ZERO_V3);
+}
 vector3 MyRigidBody::GetHalfWidth(void) { return m_v3HalfWidth; }
 matrix4 MyRigidBody::GetModelMatrix(void) { return m_m4ToWorld; }
 void MyRigidBody::SetModelMatrix(matrix4 a_m4ModelMatrix)
@@ -91,6 +112,7 @@ void MyRigidBody::SetModelMatrix(matrix4 a_m4ModelMatrix)
 	//Assign the model matrix
 	m_m4ToWorld = a_m4ModelMatrix;
 
+	vector3 v3PreviousCenter = m_v3CenterG;
 	m_v3CenterG = vector3(m_m4ToWorld * vector4(m_v3CenterL, 1.0f));
 
 	//Calculate the 8 corners of the cube
@@ -131,6 +153,31 @@ void MyRigidBody::SetModelMatrix(matrix4 a_m4ModelMatrix)
 
 	//we calculate the distance between min and max vectors
 	m_v3ARBBSize = m_v3MaxG - m_v3MinG;
+
+	UpdateProxy(m_v3CenterG - v3PreviousCenter);
+}
+void MyRigidBody::UpdateProxy(vector3 a_v3Movement)
+{
+	//without a margin the proxy box follows the global box exactly
+	if (m_fProxyMargin <= 0.0f && m_fProxyVelocityScale <= 0.0f)
+	{
+		m_v3ProxyMin = m_v3MinG;
+		m_v3ProxyMax = m_v3MaxG;
+		return;
+	}
+
+	//while the global box stays inside the proxy box there is nothing to do
+	if (m_v3MinG.x >= m_v3ProxyMin.x && m_v3MinG.y >= m_v3ProxyMin.y && m_v3MinG.z >= m_v3ProxyMin.z &&
+		m_v3MaxG.x <= m_v3ProxyMax.x && m_v3MaxG.y <= m_v3ProxyMax.y && m_v3MaxG.z <= m_v3ProxyMax.z)
+		return;
+
+	//refit with the margin and reach ahead along the movement so the next steps stay inside,
+	//never further than the size of the box so a jump does not leave a huge proxy behind
+	m_v3ProxyMin = m_v3MinG - vector3(m_fProxyMargin);
+	m_v3ProxyMax = m_v3MaxG + vector3(m_fProxyMargin);
+	vector3 v3Ahead = glm::clamp(a_v3Movement * m_fProxyVelocityScale, -m_v3ARBBSize, m_v3ARBBSize);
+	m_v3ProxyMin += glm::min(v3Ahead, ZERO_V3);
+	m_v3ProxyMax += glm::max(v3Ahead, ZERO_V3);
 }
 //The big 3
 MyRigidBody::MyRigidBody(std::vector<vector3> a_pointList)
@@ -162,6 +209,8 @@ MyRigidBody::MyRigidBody(std::vector<vector3> a_pointList)
 	//with model matrix being the identity, local and global are the same
 	m_v3MinG = m_v3MinL;
 	m_v3MaxG = m_v3MaxL;
+	m_v3ProxyMin = m_v3MinG;
+	m_v3ProxyMax = m_v3MaxG;
 
 	//with the max and the min we calculate the center
 	m_v3CenterL = (m_v3MaxL + m_v3MinL) / 2.0f;
@@ -193,6 +242,11 @@ MyRigidBody::MyRigidBody(MyRigidBody const& other)
 	m_v3MinG = other.m_v3MinG;
 	m_v3MaxG = other.m_v3MaxG;
 
+	m_v3ProxyMin = other.m_v3ProxyMin;
+	m_v3ProxyMax = other.m_v3ProxyMax;
+	m_fProxyMargin = other.m_fProxyMargin;
+	m_fProxyVelocityScale = other.m_fProxyVelocityScale;
+
 	m_v3HalfWidth = other.m_v3HalfWidth;
 	m_v3ARBBSize = other.m_v3ARBBSize;
 
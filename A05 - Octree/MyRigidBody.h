@@ -34,6 +34,11 @@ class MyRigidBody
 	vector3 m_v3MinG = ZERO_V3; //minimum coordinate in global space (for ARBB)
 	vector3 m_v3MaxG = ZERO_V3; //maximum coordinate in global space (for ARBB)
 
+	vector3 m_v3ProxyMin = ZERO_V3; //minimum of the proxy box, a box around the ARBB that spatial structures track
+	vector3 m_v3ProxyMax = ZERO_V3; //maximum of the proxy box
+	float m_fProxyMargin = 0.0f; //distance the proxy box reaches past the ARBB on every side when it is refit
+	float m_fProxyVelocityScale = 0.0f; //how many times the last movement the proxy box is stretched ahead by
+
 	vector3 m_v3HalfWidth = ZERO_V3; //half the size of the Oriented Bounding Box
 	vector3 m_v3ARBBSize = ZERO_V3;// size of the Axis (Re)Alligned Bounding Box
 
@@ -212,6 +217,35 @@ public:
 	*/
 	vector3 GetMaxGlobal(void);
 	/*
+	Usage: Gets minimum vector of the proxy box, it contains the global box and only changes when
+	the global box escapes it
+	Arguments: ---
+	Output: min vector
+	*/
+	vector3 GetProxyMin(void);
+	/*
+	Usage: Gets maximum vector of the proxy box
+	Arguments: ---
+	Output: max vector
+	*/
+	vector3 GetProxyMax(void);
+	/*
+	Usage: Gets the distance the proxy box reaches past the global box
+	Arguments: ---
+	Output: margin
+	*/
+	float GetProxyMargin(void);
+	/*
+	Usage: Sets how far the proxy box reaches past the global box and refits it, with no margin and
+	no velocity scale the proxy box is the global box
+	Arguments:
+	- float a_fMargin -> distance added on every side
+	- float a_fVelocityScale = 0.0f -> the box is also stretched this many times the last movement
+	of the center ahead of the body
+	Output: ---
+	*/
+	void SetProxyMargin(float a_fMargin, float a_fVelocityScale = 0.0f);
+	/*
 	Usage: Gets the size of the model divided by 2
 	Arguments: ---
 	Output: halfwidth vector
@@ -256,6 +290,12 @@ private:
 	OUTPUT: 0 for colliding, all other first axis that succeeds test
 	*/
 	uint SAT(MyRigidBody* const a_pOther);
+	/*
+	USAGE: Refits the proxy box around the global box if the global box escaped it
+	ARGUMENTS: vector3 a_v3Movement -> movement of the center since the last model matrix
+	OUTPUT: ---
+	*/
+	void UpdateProxy(vector3 a_v3Movement);
 };//class
 
 } //namespace Simplex
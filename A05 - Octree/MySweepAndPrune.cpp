@@ -0,0 +1,301 @@
+#include "MySweepAndPrune.h"
+using namespace Simplex;
+
+//Constructor for the sweep and prune
+MySweepAndPrune::MySweepAndPrune()
+{
+	Init();
+	Rebuild();
+}
+
+//Copy constructor for the sweep and prune
+MySweepAndPrune::MySweepAndPrune(MySweepAndPrune const& other)
+{
+	for(uint i = 0; i < 3; i++)
+	{
+		m_lEndpoint[i] = other.m_lEndpoint[i];
+		m_lEndpointIndex[i] = other.m_lEndpointIndex[i];
+	}
+	m_lEntityMin = other.m_lEntityMin;
+	m_lEntityMax = other.m_lEntityMax;
+	m_lPair = other.m_lPair;
+	m_uSwapCount = other.m_uSwapCount;
+	m_pMeshMngr = MeshManager::GetInstance();
+	m_pEntityMngr = MyEntityManager::GetInstance();
+}
+
+//Copy assignment operator for the sweep and prune
+MySweepAndPrune& MySweepAndPrune::operator=(MySweepAndPrune const& other)
+{
+	if(this != &other)
+	{
+		Release();
+		Init();
+		MySweepAndPrune sweep(other);
+		Swap(sweep);
+	}
+	return *this;
+}
+
+//Destructor for the sweep and prune
+MySweepAndPrune::~MySweepAndPrune()
+{
+	Release();
+}
+
+//Swaps the values of the sweep and prune with the values of the one passed in
+void MySweepAndPrune::Swap(MySweepAndPrune& other)
+{
+	for(uint i = 0; i < 3; i++)
+	{
+		std::swap(m_lEndpoint[i], other.m_lEndpoint[i]);
+		std::swap(m_lEndpointIndex[i], other.m_lEndpointIndex[i]);
+	}
+	std::swap(m_lEntityMin, other.m_lEntityMin);
+	std::swap(m_lEntityMax, other.m_lEntityMax);
+	std::swap(m_lPair, other.m_lPair);
+	std::swap(m_uSwapCount, other.m_uSwapCount);
+	m_pMeshMngr = MeshManager::GetInstance();
+	m_pEntityMngr = MyEntityManager::GetInstance();
+}
+
+//Updates the ends of the entities that moved
+void MySweepAndPrune::UpdateEntities()
+{
+	uint entityCount = m_pEntityMngr->GetEntityCount();
+	//Added or removed entities change the length of every axis, so the axes are sorted from scratch
+	if(entityCount != m_lEntityMin.size())
+	{
+		Rebuild();
+		return;
+	}
+	m_uSwapCount = 0;
+	bool moved = false;
+	std::vector<vector3> const& lProxyMin = m_pEntityMngr->GetProxyMinList();
+	std::vector<vector3> const& lProxyMax = m_pEntityMngr->GetProxyMaxList();
+	for(uint i = 0; i < entityCount; i++)
+	{
+		vector3 minimum = lProxyMin[i];
+		vector3 maximum = lProxyMax[i];
+		if(minimum == m_lEntityMin[i] && maximum == m_lEntityMax[i])
+		{
+			continue;
+		}
+		m_lEntityMin[i] = minimum;
+		m_lEntityMax[i] = maximum;
+		for(uint j = 0; j < 3; j++)
+		{
+			m_lEndpoint[j][m_lEndpointIndex[j][2 * i]].m_fValue = minimum[j];
+			m_lEndpoint[j][m_lEndpointIndex[j][2 * i + 1]].m_fValue = maximum[j];
+		}
+		moved = true;
+	}
+	if(!moved)
+	{
+		return;
+	}
+	//Every bound is already final, so each swap can check the pair on all three axes at once
+	for(uint i = 0; i < 3; i++)
+	{
+		SortAxis(i);
+	}
+}
+
+//Lists the overlapping pairs
+void MySweepAndPrune::GetCandidatePairs(std::vector<std::pair<uint, uint>>& a_lPair)
+{
+	a_lPair.clear();
+	a_lPair.reserve(m_lPair.size());
+	for(std::unordered_set<unsigned long long>::iterator it = m_lPair.begin(); it != m_lPair.end(); ++it)
+	{
+		a_lPair.push_back(std::make_pair((uint)(*it >> 32), (uint)(*it & 0xFFFFFFFF)));
+	}
+}
+
+//Displays the entities that overlap another
+void MySweepAndPrune::Display(vector3 a_v3Color)
+{
+	for(std::unordered_set<unsigned long long>::iterator it = m_lPair.begin(); it != m_lPair.end(); ++it)
+	{
+		uint entity[2] = { (uint)(*it >> 32), (uint)(*it & 0xFFFFFFFF) };
+		for(uint i = 0; i < 2; i++)
+		{
+			vector3 center = (m_lEntityMin[entity[i]] + m_lEntityMax[entity[i]]) / 2.0f;
+			vector3 size = m_lEntityMax[entity[i]] - m_lEntityMin[entity[i]];
+			m_pMeshMngr->AddWireCubeToRenderList(glm::translate(IDENTITY_M4, center) * glm::scale(size), a_v3Color, RENDER_WIRE);
+		}
+	}
+}
+
+//Gets the memory the sweep holds
+size_t MySweepAndPrune::GetMemoryUsage()
+{
+	size_t memory = sizeof(MySweepAndPrune);
+	for(uint i = 0; i < 3; i++)
+	{
+		memory += m_lEndpoint[i].capacity() * sizeof(MySweepEndpoint);
+		memory += m_lEndpointIndex[i].capacity() * sizeof(uint);
+	}
+	memory += (m_lEntityMin.capacity() + m_lEntityMax.capacity()) * sizeof(vector3);
+	memory += m_lActive.capacity() * sizeof(uint);
+	//Each key of the set lives in its own list node next to the pointer array of the buckets
+	memory += m_lPair.bucket_count() * sizeof(void*);
+	memory += m_lPair.size() * (sizeof(unsigned long long) + 2 * sizeof(void*));
+	return memory;
+}
+
+//Gets the pair count
+uint MySweepAndPrune::GetPairCount()
+{
+	return m_lPair.size();
+}
+
+//Gets the swap count
+uint MySweepAndPrune::GetSwapCount()
+{
+	return m_uSwapCount;
+}
+
+//Release the sweep and prune (used in the destructor)
+void MySweepAndPrune::Release()
+{
+	for(uint i = 0; i < 3; i++)
+	{
+		m_lEndpoint[i].clear();
+		m_lEndpointIndex[i].clear();
+	}
+	m_lEntityMin.clear();
+	m_lEntityMax.clear();
+	m_lPair.clear();
+	m_lActive.clear();
+}
+
+//Initialize the sweep and prune without entities
+void MySweepAndPrune::Init()
+{
+	m_pMeshMngr = MeshManager::GetInstance();
+	m_pEntityMngr = MyEntityManager::GetInstance();
+	m_uSwapCount = 0;
+}
+
+//Sorts every entity from scratch
+void MySweepAndPrune::Rebuild()
+{
+	uint entityCount = m_pEntityMngr->GetEntityCount();
+	m_lEntityMin = m_pEntityMngr->GetProxyMinList();
+	m_lEntityMax = m_pEntityMngr->GetProxyMaxList();
+	for(uint i = 0; i < 3; i++)
+	{
+		std::vector<MySweepEndpoint>& lEndpoint = m_lEndpoint[i];
+		lEndpoint.resize(2 * entityCount);
+		for(uint j = 0; j < entityCount; j++)
+		{
+			lEndpoint[2 * j].m_fValue = m_lEntityMin[j][i];
+			lEndpoint[2 * j].m_uEntity = j;
+			lEndpoint[2 * j].m_bMax = false;
+			lEndpoint[2 * j + 1].m_fValue = m_lEntityMax[j][i];
+			lEndpoint[2 * j + 1].m_uEntity = j;
+			lEndpoint[2 * j + 1].m_bMax = true;
+		}
+		std::sort(lEndpoint.begin(), lEndpoint.end(), IsBefore);
+		m_lEndpointIndex[i].resize(2 * entityCount);
+		for(uint j = 0; j < 2 * entityCount; j++)
+		{
+			m_lEndpointIndex[i][2 * lEndpoint[j].m_uEntity + lEndpoint[j].m_bMax] = j;
+		}
+	}
+	//Sweeps x, each entity starting is checked against the entities that started and have not ended
+	m_lPair.clear();
+	m_lActive.clear();
+	std::vector<MySweepEndpoint>& lEndpoint = m_lEndpoint[0];
+	for(uint i = 0; i < 2 * entityCount; i++)
+	{
+		uint entity = lEndpoint[i].m_uEntity;
+		if(lEndpoint[i].m_bMax)
+		{
+			std::vector<uint>::iterator found = std::find(m_lActive.begin(), m_lActive.end(), entity);
+			*found = m_lActive.back();
+			m_lActive.pop_back();
+			continue;
+		}
+		uint activeCount = m_lActive.size();
+		for(uint j = 0; j < activeCount; j++)
+		{
+			if(IsOverlapping(entity, m_lActive[j]))
+			{
+				m_lPair.insert(GetPairKey(entity, m_lActive[j]));
+			}
+		}
+		m_lActive.push_back(entity);
+	}
+	m_uSwapCount = 0;
+}
+
+//Sorts an axis and follows the pairs that cross
+void MySweepAndPrune::SortAxis(uint a_uAxis)
+{
+	std::vector<MySweepEndpoint>& lEndpoint = m_lEndpoint[a_uAxis];
+	std::vector<uint>& lEndpointIndex = m_lEndpointIndex[a_uAxis];
+	uint endpointCount = lEndpoint.size();
+	for(uint i = 1; i < endpointCount; i++)
+	{
+		MySweepEndpoint endpoint = lEndpoint[i];
+		uint j = i;
+		while(j > 0 && IsBefore(endpoint, lEndpoint[j - 1]))
+		{
+			MySweepEndpoint const& other = lEndpoint[j - 1];
+			if(endpoint.m_bMax != other.m_bMax)
+			{
+				if(!endpoint.m_bMax)
+				{
+					//A minimum passed a maximum, the two start to overlap along this axis
+					if(IsOverlapping(endpoint.m_uEntity, other.m_uEntity))
+					{
+						m_lPair.insert(GetPairKey(endpoint.m_uEntity, other.m_uEntity));
+					}
+				}
+				else
+				{
+					//A maximum passed a minimum, the two no longer overlap along this axis
+					m_lPair.erase(GetPairKey(endpoint.m_uEntity, other.m_uEntity));
+				}
+			}
+			lEndpoint[j] = other;
+			lEndpointIndex[2 * other.m_uEntity + other.m_bMax] = j;
+			m_uSwapCount++;
+			j--;
+		}
+		lEndpoint[j] = endpoint;
+		lEndpointIndex[2 * endpoint.m_uEntity + endpoint.m_bMax] = j;
+	}
+}
+
+//Checks if the bounds of two entities overlap
+bool MySweepAndPrune::IsOverlapping(uint a_uFirst, uint a_uSecond)
+{
+	vector3 overlapMin = glm::max(m_lEntityMin[a_uFirst], m_lEntityMin[a_uSecond]);
+	vector3 overlapMax = glm::min(m_lEntityMax[a_uFirst], m_lEntityMax[a_uSecond]);
+	if(overlapMin.x > overlapMax.x || overlapMin.y > overlapMax.y || overlapMin.z > overlapMax.z)
+	{
+		return false;
+	}
+	return true;
+}
+
+//Packs a pair in to a key
+unsigned long long MySweepAndPrune::GetPairKey(uint a_uFirst, uint a_uSecond)
+{
+	unsigned long long lower = std::min(a_uFirst, a_uSecond);
+	unsigned long long higher = std::max(a_uFirst, a_uSecond);
+	return (lower << 32) | higher;
+}
+
+//Orders the ends of an axis
+bool MySweepAndPrune::IsBefore(MySweepEndpoint const& a_First, MySweepEndpoint const& a_Second)
+{
+	if(a_First.m_fValue != a_Second.m_fValue)
+	{
+		return a_First.m_fValue < a_Second.m_fValue;
+	}
+	return !a_First.m_bMax && a_Second.m_bMax;
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "MyBroadPhase.h"
+#include <unordered_set>
+
+namespace Simplex
+{
+	//End of the bounds of an entity along one axis
+	struct MySweepEndpoint
+	{
+		float m_fValue = 0.0f; //coordinate of the end along the axis
+		uint m_uEntity = 0; //index of the entity
+		bool m_bMax = false; //is the maximum of the bounds (the minimum otherwise)
+	};
+
+	//Keeps the ends of the bounds of every entity sorted along each axis and the set of overlapping
+	//pairs up to date with the swaps an insertion sort makes each frame, entities that barely move
+	//only cost a few swaps
+	class MySweepAndPrune : public MyBroadPhase
+	{
+		MeshManager* m_pMeshMngr = nullptr; //mesh manager singleton
+		MyEntityManager* m_pEntityMngr = nullptr; //entity manager singleton
+
+		std::vector<MySweepEndpoint> m_lEndpoint[3]; //ends of every entity sorted along x, y and z
+		std::vector<uint> m_lEndpointIndex[3]; //position in m_lEndpoint of the minimum (2 * entity) and maximum (2 * entity + 1) of each entity
+		std::vector<vector3> m_lEntityMin; //minimum of each entity's proxy box at the last update
+		std::vector<vector3> m_lEntityMax; //maximum of each entity's proxy box at the last update
+		std::unordered_set<unsigned long long> m_lPair; //overlapping pairs, lower index in the high 32 bits
+		std::vector<uint> m_lActive; //entities whose bounds the sweep of a rebuild is inside of
+		uint m_uSwapCount = 0; //swaps the last update made
+
+	public:
+		/*
+		USAGE: Constructor, sorts the ends of every entity the entity manager holds
+		ARGUMENTS: ---
+		OUTPUT: class object
+		*/
+		MySweepAndPrune();
+		/*
+		USAGE: Copy constructor
+		ARGUMENTS: class object to copy
+		OUTPUT: class object instance
+		*/
+		MySweepAndPrune(MySweepAndPrune const& other);
+		/*
+		USAGE: Copy assignment operator
+		ARGUMENTS: class object to copy
+		OUTPUT: ---
+		*/
+		MySweepAndPrune& operator=(MySweepAndPrune const& other);
+		/*
+		USAGE: Destructor
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		~MySweepAndPrune();
+		/*
+		USAGE: Changes object contents for other object's
+		ARGUMENTS:
+		- MySweepAndPrune& other -> object to swap content from
+		OUTPUT: ---
+		*/
+		void Swap(MySweepAndPrune& other);
+		/*
+		USAGE: Moves the ends of the entities whose bounds changed and sorts each axis again, adding the
+		pairs that start to overlap and removing the ones that stop; if entities were added or removed
+		the ends are sorted from scratch
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		virtual void UpdateEntities() override;
+		/*
+		USAGE: Lists each pair of entities whose proxy boxes overlap exactly once
+		ARGUMENTS:
+		- std::vector<std::pair<uint, uint>>& a_lPair -> output, pairs of entity indices (lower index first)
+		OUTPUT: ---
+		*/
+		virtual void GetCandidatePairs(std::vector<std::pair<uint, uint>>& a_lPair) override;
+		/*
+		USAGE: Displays the bounds of the entities that overlap another in the color specified
+		ARGUMENTS:
+		- vector3 a_v3Color = C_YELLOW -> color of the volumes to display
+		OUTPUT: ---
+		*/
+		virtual void Display(vector3 a_v3Color = C_YELLOW) override;
+		/*
+		USAGE: Gets the memory the sweep holds on to, the capacity of its arrays and the buckets of the pair set included
+		ARGUMENTS: ---
+		OUTPUT: bytes
+		*/
+		virtual size_t GetMemoryUsage() override;
+		/*
+		USAGE: Gets the number of overlapping pairs
+		ARGUMENTS: ---
+		OUTPUT: pair count
+		*/
+		uint GetPairCount();
+		/*
+		USAGE: Gets the number of swaps the last update made, what the update cost
+		ARGUMENTS: ---
+		OUTPUT: swap count
+		*/
+		uint GetSwapCount();
+
+	private:
+		/*
+		USAGE: Deallocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Release();
+		/*
+		USAGE: Allocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Init();
+		/*
+		USAGE: Copies the bounds of every entity, sorts the ends of each axis and finds the overlapping
+		pairs with a sweep along x
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Rebuild();
+		/*
+		USAGE: Sorts the ends of an axis with an insertion sort, a minimum passing a maximum adds the pair
+		if the bounds overlap and a maximum passing a minimum removes it
+		ARGUMENTS:
+		- uint a_uAxis -> axis to sort (0 x, 1 y, 2 z)
+		OUTPUT: ---
+		*/
+		void SortAxis(uint a_uAxis);
+		/*
+		USAGE: Asks if the bounds of two entities overlap
+		ARGUMENTS:
+		- uint a_uFirst -> index of the first entity
+		- uint a_uSecond -> index of the second entity
+		OUTPUT: overlap
+		*/
+		bool IsOverlapping(uint a_uFirst, uint a_uSecond);
+		/*
+		USAGE: Packs a pair of entities in to the key of the pair set
+		ARGUMENTS:
+		- uint a_uFirst -> index of the first entity
+		- uint a_uSecond -> index of the second entity
+		OUTPUT: key with the lower index in the high 32 bits
+		*/
+		static unsigned long long GetPairKey(uint a_uFirst, uint a_uSecond);
+		/*
+		USAGE: Asks if an end goes before another, at the same coordinate minimums go first so bounds
+		that touch count as overlapping
+		ARGUMENTS:
+		- MySweepEndpoint const& a_First -> first end
+		- MySweepEndpoint const& a_Second -> second end
+		OUTPUT: goes before
+		*/
+		static bool IsBefore(MySweepEndpoint const& a_First, MySweepEndpoint const& a_Second);
+	};
+}
@@ -0,0 +1,120 @@
+#include "MyWorkerPool.h"
+#include <algorithm>
+using namespace Simplex;
+
+MyWorkerPool* MyWorkerPool::m_pInstance = nullptr;
+std::mutex MyWorkerPool::m_InstanceMutex;
+
+//Gets the singleton
+MyWorkerPool* MyWorkerPool::GetInstance(void)
+{
+	//The first builds can ask for the pool from the builder's thread and the main thread at once
+	std::lock_guard<std::mutex> lock(m_InstanceMutex);
+	if(m_pInstance == nullptr)
+	{
+		m_pInstance = new MyWorkerPool();
+	}
+	return m_pInstance;
+}
+
+//Releases the singleton
+void MyWorkerPool::ReleaseInstance(void)
+{
+	std::lock_guard<std::mutex> lock(m_InstanceMutex);
+	if(m_pInstance != nullptr)
+	{
+		delete m_pInstance;
+		m_pInstance = nullptr;
+	}
+}
+
+//Starts the threads
+MyWorkerPool::MyWorkerPool(void)
+{
+	uint workerCount = std::thread::hardware_concurrency();
+	for(uint i = 1; i < workerCount; i++)
+	{
+		m_lWorker.push_back(std::thread(&MyWorkerPool::WorkerLoop, this));
+	}
+}
+
+//Stops the threads
+MyWorkerPool::~MyWorkerPool(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_bStop = true;
+	}
+	m_JobReady.notify_all();
+	for(uint i = 0; i < m_lWorker.size(); i++)
+	{
+		m_lWorker[i].join();
+	}
+}
+
+//Gets the number of threads
+uint MyWorkerPool::GetWorkerCount(void)
+{
+	return m_lWorker.size();
+}
+
+//Runs a task for each index
+void MyWorkerPool::Run(uint a_uTaskCount, std::function<void(uint)> const& a_Task)
+{
+	if(a_uTaskCount == 0)
+	{
+		return;
+	}
+	MyWorkerJob job;
+	job.m_pTask = &a_Task;
+	job.m_uTaskCount = a_uTaskCount;
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_lJob.push_back(&job);
+	m_JobReady.notify_all();
+	//The calling thread takes indices as well, so the job finishes even when the threads are busy with other jobs
+	while(job.m_uNextTask < job.m_uTaskCount)
+	{
+		uint task = TakeTask(&job);
+		lock.unlock();
+		a_Task(task);
+		lock.lock();
+		job.m_uDoneCount++;
+	}
+	m_JobDone.wait(lock, [&job]() { return job.m_uDoneCount == job.m_uTaskCount; });
+}
+
+//Loop of each thread
+void MyWorkerPool::WorkerLoop(void)
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	while(true)
+	{
+		m_JobReady.wait(lock, [this]() { return m_bStop || !m_lJob.empty(); });
+		if(m_lJob.empty())
+		{
+			return;
+		}
+		MyWorkerJob* pJob = m_lJob.front();
+		uint task = TakeTask(pJob);
+		lock.unlock();
+		(*pJob->m_pTask)(task);
+		lock.lock();
+		//The job lives on the stack of the thread that handed it in, so it is not touched after the last index
+		pJob->m_uDoneCount++;
+		if(pJob->m_uDoneCount == pJob->m_uTaskCount)
+		{
+			m_JobDone.notify_all();
+		}
+	}
+}
+
+//Takes the next index of a job
+uint MyWorkerPool::TakeTask(MyWorkerJob* a_pJob)
+{
+	uint task = a_pJob->m_uNextTask++;
+	if(a_pJob->m_uNextTask == a_pJob->m_uTaskCount)
+	{
+		m_lJob.erase(std::find(m_lJob.begin(), m_lJob.end(), a_pJob));
+	}
+	return task;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Simplex\Simplex.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+
+namespace Simplex
+{
+	//Task list handed to the pool, every index from 0 to m_uTaskCount - 1 is run once
+	struct MyWorkerJob
+	{
+		std::function<void(uint)> const* m_pTask = nullptr; //task to run for each index
+		uint m_uTaskCount = 0; //number of indices to run the task for
+		uint m_uNextTask = 0; //next index nobody has taken
+		uint m_uDoneCount = 0; //indices that finished running
+	};
+
+	//Threads that are started once and kept waiting for jobs, so a parallel build does not have to
+	//start its own threads; more than one thread can hand in jobs at the same time
+	class MyWorkerPool
+	{
+		std::vector<std::thread> m_lWorker; //threads waiting for jobs
+		std::deque<MyWorkerJob*> m_lJob; //jobs that still have indices nobody has taken
+		std::mutex m_Mutex; //guards the job list and the counters of every job
+		std::condition_variable m_JobReady; //woken when a job is handed in or the pool stops
+		std::condition_variable m_JobDone; //woken when the last index of a job finishes
+		bool m_bStop = false; //the workers have to return
+
+		static MyWorkerPool* m_pInstance; //singleton pointer
+		static std::mutex m_InstanceMutex; //guards the singleton pointer
+
+	public:
+		/*
+		USAGE: Gets the singleton pointer, the threads start the first time it is asked for; any thread
+		can ask for it
+		ARGUMENTS: ---
+		OUTPUT: singleton pointer
+		*/
+		static MyWorkerPool* GetInstance(void);
+		/*
+		USAGE: Stops the threads and releases the singleton, no job can be running
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		static void ReleaseInstance(void);
+		/*
+		USAGE: Gets the number of threads in the pool, the calling thread of Run works as well
+		ARGUMENTS: ---
+		OUTPUT: number of threads
+		*/
+		uint GetWorkerCount(void);
+		/*
+		USAGE: Runs a task once for each index on the pool and the calling thread, returns when every
+		index finished; the indices run in no particular order
+		ARGUMENTS:
+		- uint a_uTaskCount -> number of indices
+		- std::function<void(uint)> const& a_Task -> task to run for each index
+		OUTPUT: ---
+		*/
+		void Run(uint a_uTaskCount, std::function<void(uint)> const& a_Task);
+
+	private:
+		/*
+		USAGE: Constructor, starts one thread per core past the calling one
+		ARGUMENTS: ---
+		OUTPUT: class object
+		*/
+		MyWorkerPool(void);
+		/*
+		USAGE: Copy Constructor
+		ARGUMENTS: class object to copy
+		OUTPUT: class object instance
+		*/
+		MyWorkerPool(MyWorkerPool const& other);
+		/*
+		USAGE: Copy Assignment Operator
+		ARGUMENTS: class object to copy
+		OUTPUT: ---
+		*/
+		MyWorkerPool& operator=(MyWorkerPool const& other);
+		/*
+		USAGE: Destructor, stops the threads and waits for them
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		~MyWorkerPool(void);
+		/*
+		USAGE: Loop of each thread, takes indices of the oldest job until the pool stops
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void WorkerLoop(void);
+		/*
+		USAGE: Takes the next index of a job, dropping the job from the list when it was the last one;
+		the mutex has to be held
+		ARGUMENTS:
+		- MyWorkerJob* a_pJob -> job with indices left
+		OUTPUT: index taken
+		*/
+		uint TakeTask(MyWorkerJob* a_pJob);
+	};
+}